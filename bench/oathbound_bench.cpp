@@ -0,0 +1,461 @@
+// Micro and macro benchmarks for the combat and loot hot paths.
+//
+//   oathbound_bench [--filter <substr>] [--min-time <s>] [--json <file|->]
+//
+// Each case runs in growing batches until it has taken --min-time seconds,
+// then reports ns/op, heap allocations/op and items/s. --json writes the same
+// rows in a Google-Benchmark-like layout for tracking between releases.
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/rng.hpp"
+#include "core/weighted_table.hpp"
+#include "game/actor.hpp"
+#include "game/actor_store.hpp"
+#include "game/battle.hpp"
+#include "game/combat_math.hpp"
+#include "game/damage_batch.hpp"
+#include "game/drop_stats.hpp"
+#include "game/inventory.hpp"
+#include "game/item.hpp"
+#include "game/loadout.hpp"
+#include "game/loot_tables.hpp"
+#include "game/simulation.hpp"
+
+// ---------------------------------------------------------------------------
+// Allocation counting: every global operator new bumps one relaxed counter.
+
+static std::atomic<std::uint64_t> g_allocs{0};
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"   // free() pairs with the malloc() below
+#endif
+
+void* operator new(std::size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t n) { return ::operator new(n); }
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(n ? n : 1);
+}
+void* operator new[](std::size_t n, const std::nothrow_t& t) noexcept { return ::operator new(n, t); }
+void operator delete(void* p) noexcept                        { std::free(p); }
+void operator delete[](void* p) noexcept                      { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept           { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept         { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept   { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+// ---------------------------------------------------------------------------
+// Harness
+
+namespace bench {
+
+// Keeps a value alive without letting the optimiser see through it.
+template<typename T>
+inline void keep(const T& v) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&v) : "memory");
+#else
+    static volatile const void* sink; sink = &v;
+#endif
+}
+
+// A case runs `iters` operations per call and returns how many items those
+// operations processed (0 = one item per op).
+using Body = std::function<std::uint64_t(std::uint64_t iters)>;
+
+// Fixtures are built by `setup` only when the case is selected; the 1M-item
+// ones are large.
+struct Case {
+    std::string name;
+    std::function<Body()> setup;
+};
+
+struct Result {
+    std::string   name;
+    std::uint64_t iterations = 0;
+    double        nsPerOp     = 0.0;
+    double        allocsPerOp = 0.0;
+    double        itemsPerSec = 0.0;
+};
+
+Result run(const Case& c, double minTime) {
+    using clock = std::chrono::steady_clock;
+    Body body = c.setup();
+    body(1);   // warm caches and reusable buffers outside the timing
+
+    std::uint64_t iters = 1;
+    for (;;) {
+        const std::uint64_t a0 = g_allocs.load(std::memory_order_relaxed);
+        const auto t0 = clock::now();
+        std::uint64_t items = body(iters);
+        const double secs = std::chrono::duration<double>(clock::now() - t0).count();
+        const std::uint64_t allocs = g_allocs.load(std::memory_order_relaxed) - a0;
+
+        if (secs >= minTime || iters >= (1ull << 40)) {
+            if (items == 0) items = iters;
+            Result r;
+            r.name        = c.name;
+            r.iterations  = iters;
+            r.nsPerOp     = secs * 1e9 / double(iters);
+            r.allocsPerOp = double(allocs) / double(iters);
+            r.itemsPerSec = secs > 0 ? double(items) / secs : 0.0;
+            return r;
+        }
+        // Aim straight for the target, growing at most 10x per step.
+        const double want = secs > 0 ? minTime * 1.4 / secs * double(iters) : double(iters) * 10;
+        iters = std::max(iters + 1, std::min(iters * 10, static_cast<std::uint64_t>(want)));
+    }
+}
+
+void writeJson(std::FILE* f, const std::vector<Result>& rs) {
+    char date[32] = "";
+    const std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof date, "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+#if defined(OATHBOUND_RNG_MT19937)
+    const char* engine = "mt19937_64";
+#else
+    const char* engine = "xoshiro256**";
+#endif
+    std::fprintf(f, "{\n  \"context\": {\"date\": \"%s\", \"num_cpus\": %u, \"rng\": \"%s\"},\n"
+                    "  \"benchmarks\": [\n", date, std::thread::hardware_concurrency(), engine);
+    for (std::size_t i = 0; i < rs.size(); ++i) {
+        const Result& r = rs[i];
+        std::fprintf(f, "    {\"name\": \"%s\", \"iterations\": %llu, \"real_time\": %.3f, \"time_unit\": \"ns\", "
+                        "\"allocs_per_iter\": %.3f, \"items_per_second\": %.1f}%s\n",
+                     r.name.c_str(), static_cast<unsigned long long>(r.iterations), r.nsPerOp,
+                     r.allocsPerOp, r.itemsPerSec, i + 1 < rs.size() ? "," : "");
+    }
+    std::fprintf(f, "  ]\n}\n");
+}
+
+} // namespace bench
+
+// ---------------------------------------------------------------------------
+// Cases
+
+using namespace game;
+
+static Item mkWeapon(const std::string& name, int mn, int mx) {
+    Item w; w.name=name; w.kind=ItemKind::Weapon; w.slot=Slot::Weapon; w.baseMin=mn; w.baseMax=mx; return w;
+}
+
+static std::vector<bench::Case> makeCases(const LootTables& loot) {
+    std::vector<bench::Case> cs;
+
+    // WeightedTable::pick, alias table vs prefix-sum binary search.
+    for (std::size_t n : {1u, 100u, 10000u, 1000000u}) {
+        for (bool alias : {true, false}) {
+            cs.push_back({std::string("WeightedTable/pick/") + (alias ? "alias/" : "search/") + std::to_string(n), [=] {
+                auto table = std::make_shared<core::WeightedTable<int>>();
+                core::RNG gen(n);
+                for (std::size_t i = 0; i < n; ++i) table->add(static_cast<int>(i), 1.0 + gen.unit() * 99.0);
+                if (alias) table->build();
+                return bench::Body([table, rng = core::RNG(1)](std::uint64_t iters) mutable {
+                    int acc = 0;
+                    for (std::uint64_t k = 0; k < iters; ++k) acc += table->pick(rng);
+                    bench::keep(acc);
+                    return std::uint64_t(0);
+                });
+            }});
+        }
+    }
+
+    // Loot rolls: fresh Items vs refilling a warmed buffer.
+    cs.push_back({"Loot/rollWeapon", [&loot] {
+        return bench::Body([&loot, rng = core::RNG(2)](std::uint64_t iters) mutable {
+            for (std::uint64_t k = 0; k < iters; ++k) { Item w = loot.rollWeapon(rng, 1); bench::keep(w); }
+            return std::uint64_t(0);
+        });
+    }});
+    cs.push_back({"Loot/rollGear", [&loot] {
+        return bench::Body([&loot, rng = core::RNG(3)](std::uint64_t iters) mutable {
+            for (std::uint64_t k = 0; k < iters; ++k) { Item g = loot.rollGear(rng, 1); bench::keep(g); }
+            return std::uint64_t(0);
+        });
+    }});
+    for (std::size_t n : {1u, 1024u, 1000000u}) {
+        cs.push_back({"Loot/rollDrops/" + std::to_string(n), [&loot, n] {
+            auto buf = std::make_shared<std::vector<Item>>(n);
+            return bench::Body([&loot, buf, rng = core::RNG(4)](std::uint64_t iters) mutable {
+                for (std::uint64_t k = 0; k < iters; ++k) loot.rollDrops(rng, 1, buf->data(), buf->size());
+                bench::keep(*buf);
+                return iters * buf->size();
+            });
+        }});
+    }
+
+    // Damage rolls with a two-affix weapon.
+    auto affixedWeapon = [&loot] {
+        core::RNG gen(5);
+        Item w = loot.rollWeapon(gen, 1);
+        while (w.affixes.size() < 2) w = loot.rollWeapon(gen, 1);
+        return w;
+    };
+    cs.push_back({"Combat/rollDamageWithBonuses", [=] {
+        return bench::Body([w = affixedWeapon(), rng = core::RNG(6)](std::uint64_t iters) mutable {
+            int acc = 0;
+            for (std::uint64_t k = 0; k < iters; ++k) acc += rollDamageWithBonuses(w, rng, 0.1, 0.05);
+            bench::keep(acc);
+            return std::uint64_t(0);
+        });
+    }});
+    cs.push_back({"Combat/rollDamage/profile", [=] {
+        return bench::Body([p = makeSwingProfile(affixedWeapon(), 0.1, 0.05), rng = core::RNG(7)](std::uint64_t iters) mutable {
+            int acc = 0;
+            for (std::uint64_t k = 0; k < iters; ++k) acc += rollDamage(p, rng);
+            bench::keep(acc);
+            return std::uint64_t(0);
+        });
+    }});
+
+    // Batches of 1024 swings with one profile: the kernel alone on pre-drawn
+    // inputs, scalar vs AVX2, and with the draws; items are swings.
+    for (DamageKernel kernel : {DamageKernel::Scalar, DamageKernel::Avx2}) {
+        if (kernel > bestDamageKernel()) continue;
+        cs.push_back({std::string("Combat/damageBatch/") + (kernel == DamageKernel::Avx2 ? "avx2" : "scalar") + "/1024",
+                      [=] {
+            const SwingProfile p = makeSwingProfile(affixedWeapon(), 0.1, 0.05);
+            auto base  = std::make_shared<std::vector<int>>(1024);
+            auto critU = std::make_shared<std::vector<double>>(1024);
+            core::RNG gen(13);
+            for (std::size_t k = 0; k < 1024; ++k) { (*base)[k] = gen.i(p.minDmg, p.maxDmg); (*critU)[k] = gen.unit(); }
+            return bench::Body([=, out = std::vector<int>(1024)](std::uint64_t iters) mutable {
+                for (std::uint64_t k = 0; k < iters; ++k) damageBatch(p, base->data(), critU->data(), out.data(), 1024, kernel);
+                bench::keep(out);
+                return iters * 1024;
+            });
+        }});
+    }
+    cs.push_back({"Combat/rollDamageBatch/1024", [=] {
+        return bench::Body([p = makeSwingProfile(affixedWeapon(), 0.1, 0.05), rng = core::RNG(7),
+                            out = std::vector<int>(1024)](std::uint64_t iters) mutable {
+            for (std::uint64_t k = 0; k < iters; ++k) rollDamageBatch(p, rng, out.data(), out.size());
+            bench::keep(out);
+            return iters * 1024;
+        });
+    }});
+
+    // Inventory scans over n weapons and a full set of gear.
+    auto filledInventory = [&loot](std::size_t n) {
+        auto inv = std::make_shared<Inventory>();
+        core::RNG gen(8);
+        for (std::size_t i = 0; i < n; ++i) inv->addWeapon(loot.rollWeapon(gen, 1));
+        for (int i = 0; i < 64; ++i) inv->equipGear(inv->addGear(loot.rollGear(gen, 1)));
+        return inv;
+    };
+    for (std::size_t n : {1u, 1000u, 100000u, 1000000u}) {
+        cs.push_back({"Inventory/bonuses/" + std::to_string(n), [=] {
+            return bench::Body([inv = filledInventory(n)](std::uint64_t iters) {
+                for (std::uint64_t k = 0; k < iters; ++k) { GearBonuses b = inv->bonuses(); bench::keep(b); }
+                return std::uint64_t(0);
+            });
+        }});
+        cs.push_back({"Inventory/equipBest/" + std::to_string(n), [=] {
+            return bench::Body([inv = filledInventory(n)](std::uint64_t iters) {
+                for (std::uint64_t k = 0; k < iters; ++k) { bool ok = inv->equipBest(); bench::keep(ok); }
+                return iters * inv->weaponsCount();
+            });
+        }});
+    }
+
+    // Whole-loadout search over n level-50 gear pieces (about n/8 per slot)
+    // and n/4 weapons; items are calls.
+    for (std::size_t n : {1000u, 16000u, 64000u}) {
+        cs.push_back({"Loadout/optimize/" + std::to_string(n), [&loot, n] {
+            auto inv = std::make_shared<Inventory>();
+            core::RNG gen(14);
+            for (std::size_t i = 0; i < n; ++i) inv->addGear(loot.rollGear(gen, 50));
+            for (std::size_t i = 0; i < n / 4; ++i) inv->addWeapon(loot.rollWeapon(gen, 50));
+            return bench::Body([inv](std::uint64_t iters) {
+                for (std::uint64_t k = 0; k < iters; ++k) { LoadoutResult r = optimizeLoadout(*inv); bench::keep(r); }
+                return std::uint64_t(0);
+            });
+        }});
+    }
+
+    // Filling and dropping a 1000-item inventory, on the heap vs one arena
+    // released per fill.
+    for (bool arena : {false, true}) {
+        cs.push_back({std::string("Inventory/fill/") + (arena ? "arena" : "heap") + "/1000", [&loot, arena] {
+            return bench::Body([&loot, arena, rng = core::RNG(10)](std::uint64_t iters) mutable {
+                std::pmr::monotonic_buffer_resource region(1 << 18);
+                for (std::uint64_t k = 0; k < iters; ++k) {
+                    {
+                        Inventory inv(arena ? Inventory::allocator_type(&region) : Inventory::allocator_type());
+                        for (int i = 0; i < 1000; ++i) {
+                            if (loot.rollIsGear(rng)) inv.addGear(loot.rollGear(rng, 1));
+                            else                      inv.addWeapon(loot.rollWeapon(rng, 1));
+                        }
+                        bench::keep(inv);
+                    }
+                    region.release();
+                }
+                return iters * 1000;
+            });
+        }});
+    }
+
+    // Steady-state churn at 1000 items: each step adds a weapon and removes
+    // the oldest one by handle, with the main hand equipped throughout.
+    cs.push_back({"Inventory/churn/1000", [&loot] {
+        auto pool = std::make_shared<std::vector<Item>>();
+        core::RNG gen(11);
+        for (int i = 0; i < 4096; ++i) pool->push_back(loot.rollWeapon(gen, 1));
+        return bench::Body([pool](std::uint64_t iters) {
+            Inventory inv;
+            std::vector<ItemHandle> fifo(1000);
+            for (std::size_t i = 0; i < fifo.size(); ++i) fifo[i] = inv.weaponHandle(inv.addWeapon((*pool)[i]));
+            inv.equip(inv.indexOf(fifo[fifo.size() - 1]));
+            for (std::uint64_t k = 0; k < iters; ++k) {
+                const std::size_t at = k % fifo.size();
+                inv.remove(fifo[at]);
+                fifo[at] = inv.weaponHandle(inv.addWeapon((*pool)[k % pool->size()]));
+            }
+            bench::keep(inv);
+            return iters;
+        });
+    }});
+
+    // Streaming drop statistics: one pre-rolled level-40 drop into a
+    // DropStats per item.
+    cs.push_back({"DropStats/addDrop", [&loot] {
+        auto pool = std::make_shared<std::vector<Item>>();
+        core::RNG gen(12);
+        for (int i = 0; i < 4096; ++i) {
+            pool->push_back(loot.rollIsGear(gen) ? loot.rollGear(gen, 40) : loot.rollWeapon(gen, 40));
+        }
+        return bench::Body([pool, stats = std::make_shared<DropStats>()](std::uint64_t iters) {
+            for (std::uint64_t k = 0; k < iters; ++k) stats->addDrop((*pool)[k & 4095]);
+            bench::keep(stats->drops());
+            return iters;
+        });
+    }});
+
+    // Whole encounters through simulate(). Enemies hit for nothing so every
+    // pack is fought to the end; items are rounds.
+    for (std::size_t n : {1u, 10u, 1000u, 10000u}) {
+        cs.push_back({"Encounter/simulate/" + std::to_string(n), [&loot, n] {
+            SimConfig cfg;
+            cfg.player = Actor{"Player", 60, 60, 1, mkWeapon("Rusty Sword", 2, 6)};
+            cfg.enemies.assign(n, Actor{"Goblin", 20, 20, 0, mkWeapon("Shiv", 0, 0)});
+            cfg.maxRounds = static_cast<int>(n) * 20;
+            cfg.autoEquip = false;
+            return bench::Body([cfg, &loot, rng = core::RNG(9)](std::uint64_t iters) mutable {
+                SimStats s = simulate(cfg, loot, rng, iters);
+                bench::keep(s);
+                return s.rounds;
+            });
+        }});
+    }
+
+    // One enemy attack phase against the player, n enemies as an Actor
+    // vector vs ActorStore columns; items are swings.
+    for (std::size_t n : {100u, 10000u}) {
+        cs.push_back({"Actors/attackPhase/aos/" + std::to_string(n), [n] {
+            auto enemies = std::make_shared<std::vector<Actor>>(n, Actor{"Goblin", 20, 20, 0, mkWeapon("Shiv", 1, 4)});
+            return bench::Body([enemies, rng = core::RNG(12)](std::uint64_t iters) mutable {
+                std::int64_t total = 0;
+                for (std::uint64_t k = 0; k < iters; ++k) {
+                    Actor player{"Player", 1 << 30, 1 << 30, 1, Item{}};
+                    for (const Actor& e : *enemies) {
+                        if (e.alive()) total += e.attack(player, rng);
+                    }
+                }
+                bench::keep(total);
+                return iters * enemies->size();
+            });
+        }});
+        cs.push_back({"Actors/attackPhase/soa/" + std::to_string(n), [n] {
+            auto store = std::make_shared<ActorStore>();
+            for (std::size_t i = 0; i < n; ++i) store->add(Actor{"Goblin", 20, 20, 0, mkWeapon("Shiv", 1, 4)});
+            return bench::Body([store, rng = core::RNG(12)](std::uint64_t iters) mutable {
+                std::int64_t total = 0;
+                for (std::uint64_t k = 0; k < iters; ++k) total += store->attackPhase(rng, 1);
+                bench::keep(total);
+                return iters * store->aliveCount();
+            });
+        }});
+    }
+
+    // Timeline battles: n/10 armored heroes against n goblins; items are swings.
+    for (std::size_t n : {10u, 1000u, 100000u}) {
+        cs.push_back({"Battle/run/" + std::to_string(n), [n] {
+            std::vector<Actor> allies(std::max<std::size_t>(1, n / 10), Actor{"Hero", 400, 400, 1, mkWeapon("Sword", 6, 12)});
+            std::vector<Actor> enemies(n, Actor{"Goblin", 20, 20, 0, mkWeapon("Shiv", 1, 4)});
+            return bench::Body([allies, enemies, rng = core::RNG(11)](std::uint64_t iters) mutable {
+                std::uint64_t swings = 0;
+                for (std::uint64_t k = 0; k < iters; ++k) {
+                    Battle b(allies, enemies);
+                    swings += b.run(rng, 1e9).swings;
+                }
+                return swings;
+            });
+        }});
+    }
+    return cs;
+}
+
+static void print_usage() {
+    std::cout <<
+    "Usage: oathbound_bench [options]\n"
+    "  --filter <s>       only run cases whose name contains s\n"
+    "  --min-time <s>     seconds per case (default 0.5)\n"
+    "  --json <file|->    also write results as JSON (- = stdout)\n"
+    "  --list             print case names and exit\n";
+}
+
+int main(int argc, char** argv) {
+    std::string filter, jsonPath;
+    double minTime = 0.5;
+    bool list = false;
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        const bool hasVal = i + 1 < argc;
+        if      (!std::strcmp(a, "--filter") && hasVal)   filter = argv[++i];
+        else if (!std::strcmp(a, "--min-time") && hasVal) minTime = std::atof(argv[++i]);
+        else if (!std::strcmp(a, "--json") && hasVal)     jsonPath = argv[++i];
+        else if (!std::strcmp(a, "--list"))               list = true;
+        else { print_usage(); return 1; }
+    }
+
+    const LootTables loot = makeDefaultLoot();
+    const std::vector<bench::Case> cases = makeCases(loot);
+    std::vector<bench::Result> results;
+    std::FILE* table = jsonPath == "-" ? stderr : stdout;
+    if (!list) std::fprintf(table, "%-40s %14s %12s %10s %14s\n", "Benchmark", "Iterations", "ns/op", "allocs/op", "items/s");
+    for (const auto& c : cases) {
+        if (!filter.empty() && c.name.find(filter) == std::string::npos) continue;
+        if (list) { std::printf("%s\n", c.name.c_str()); continue; }
+        const bench::Result r = bench::run(c, minTime);
+        std::fprintf(table, "%-40s %14llu %12.1f %10.2f %14.4g\n", r.name.c_str(),
+                     static_cast<unsigned long long>(r.iterations), r.nsPerOp, r.allocsPerOp, r.itemsPerSec);
+        std::fflush(table);
+        results.push_back(r);
+    }
+
+    if (!jsonPath.empty() && !list) {
+        std::FILE* f = jsonPath == "-" ? stdout : std::fopen(jsonPath.c_str(), "w");
+        if (!f) { std::fprintf(stderr, "cannot write %s\n", jsonPath.c_str()); return 1; }
+        bench::writeJson(f, results);
+        if (f != stdout) std::fclose(f);
+    }
+    return 0;
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace core {
+
+// Fixed-size log-linear histogram for non-negative samples. Each power of two
+// in [2^kMinExp, 2^kMaxExp) is split into kSub equal bins, found from the
+// double's exponent and top mantissa bits (no log() per sample). Quantiles
+// return a bin's lower edge, so they are within 1/kSub relative of the true
+// value and exact for integers below 2 * kSub. Smaller samples (and zero)
+// share the first bin, larger ones the last.
+//
+// Merging adds bin counts, so it is exact and order-independent for
+// everything but sum(), which is a floating-point total.
+class QuantileSketch {
+public:
+    static constexpr int         kMinExp  = -8;
+    static constexpr int         kMaxExp  = 32;
+    static constexpr int         kSubBits = 6;
+    static constexpr std::size_t kSub     = std::size_t(1) << kSubBits;
+    static constexpr std::size_t kBins    = 2 + std::size_t(kMaxExp - kMinExp) * kSub;
+
+    QuantileSketch() : bins_(kBins, 0) {}
+
+    void add(double v, std::uint64_t times = 1) {
+        bins_[binOf(v)] += times;
+        count_ += times;
+        sum_   += v * double(times);
+        min_ = std::min(min_, v);
+        max_ = std::max(max_, v);
+    }
+
+    void merge(const QuantileSketch& o) {
+        for (std::size_t i = 0; i < kBins; ++i) bins_[i] += o.bins_[i];
+        count_ += o.count_;
+        sum_   += o.sum_;
+        min_ = std::min(min_, o.min_);
+        max_ = std::max(max_, o.max_);
+    }
+
+    std::uint64_t count() const { return count_; }
+    double sum() const     { return sum_; }
+    double mean() const    { return count_ ? sum_ / double(count_) : 0.0; }
+    double lowest() const  { return count_ ? min_ : 0.0; }
+    double highest() const { return count_ ? max_ : 0.0; }
+
+    // Sample at rank floor(q * (count - 1)), q in [0, 1].
+    double quantile(double q) const {
+        if (count_ == 0) return 0.0;
+        const double r = std::clamp(q, 0.0, 1.0) * double(count_ - 1);
+        const auto rank = static_cast<std::uint64_t>(r);
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBins; ++i) {
+            seen += bins_[i];
+            if (seen > rank) return std::clamp(lowerEdge(i), min_, max_);
+        }
+        return max_;
+    }
+
+    // Raw bins, for exporting histograms: count of bin i and its lower edge.
+    std::size_t   bins() const                  { return kBins; }
+    std::uint64_t binCount(std::size_t i) const { return bins_[i]; }
+    static double lowerEdge(std::size_t i) {
+        if (i == 0) return 0.0;
+        if (i == kBins - 1) return std::ldexp(1.0, kMaxExp);
+        const int e = kMinExp + static_cast<int>((i - 1) / kSub);
+        return std::ldexp(1.0 + double((i - 1) % kSub) / double(kSub), e);
+    }
+
+private:
+    static std::size_t binOf(double v) {
+        if (!(v >= std::ldexp(1.0, kMinExp))) return 0;   // also NaN
+        if (v >= std::ldexp(1.0, kMaxExp)) return kBins - 1;
+        std::uint64_t bits;
+        std::memcpy(&bits, &v, sizeof bits);
+        const int e = static_cast<int>((bits >> 52) & 0x7FF) - 1023;
+        const std::uint64_t m = (bits >> (52 - kSubBits)) & (kSub - 1);
+        return 1 + std::size_t(e - kMinExp) * kSub + std::size_t(m);
+    }
+
+    std::vector<std::uint64_t> bins_;
+    std::uint64_t count_ = 0;
+    double sum_ = 0.0;
+    double min_ = std::numeric_limits<double>::infinity();
+    double max_ = -std::numeric_limits<double>::infinity();
+};
+
+} // namespace core
@@ -1,14 +1,92 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <random>
+#include "core/xoshiro.hpp"
+#if defined(_MSC_VER) && !defined(__SIZEOF_INT128__)
+#include <intrin.h>
+#endif
 
 namespace core {
 
-struct RNG {
-    std::mt19937_64 eng;
-    explicit RNG(uint64_t seed = std::random_device{}()) : eng(seed) {}
-    int i(int a, int b) { std::uniform_int_distribution<int> d(a,b); return d(eng); }
-    double f(double a, double b) { std::uniform_real_distribution<double> d(a,b); return d(eng); }
-    bool chance(double p) { return f(0.0,1.0) < p; }
+// Seed for the stream-th independent sub-stream of a run seeded with `seed`.
+inline std::uint64_t streamSeed(std::uint64_t seed, std::uint64_t stream) {
+    std::uint64_t x = seed;
+    std::uint64_t y = splitmix64(x) ^ (stream * 0xD1B54A32D192ED03ull);
+    return splitmix64(y);
+}
+
+// Full 64x64 -> 128 bit product; returns the high half, low half in `lo`.
+inline std::uint64_t mul128(std::uint64_t a, std::uint64_t b, std::uint64_t& lo) {
+#if defined(__SIZEOF_INT128__)
+    const unsigned __int128 p = static_cast<unsigned __int128>(a) * b;
+    lo = static_cast<std::uint64_t>(p);
+    return static_cast<std::uint64_t>(p >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    std::uint64_t hi;
+    lo = _umul128(a, b, &hi);
+    return hi;
+#else
+    const std::uint64_t aL = a & 0xFFFFFFFFu, aH = a >> 32;
+    const std::uint64_t bL = b & 0xFFFFFFFFu, bH = b >> 32;
+    const std::uint64_t ll = aL * bL, lh = aL * bH, hl = aH * bL, hh = aH * bH;
+    const std::uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFFu) + (hl & 0xFFFFFFFFu);
+    lo = (mid << 32) | (ll & 0xFFFFFFFFu);
+    return hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+}
+
+// Game-facing RNG over any 64-bit engine. Bounded and real draws are done
+// here rather than through <random> distributions, so they are bias-free,
+// need no per-call setup and give the same sequence on every standard library.
+template<typename Engine>
+struct BasicRNG {
+    Engine eng;
+    explicit BasicRNG(uint64_t seed = std::random_device{}()) : eng(seed) {}
+    static BasicRNG forStream(uint64_t seed, uint64_t stream) { return BasicRNG(streamSeed(seed, stream)); }
+
+    std::uint64_t next() { return static_cast<std::uint64_t>(eng()); }
+
+    // Uniform in [0, n), n > 0 (Lemire's multiply-shift with rejection).
+    std::uint64_t below(std::uint64_t n) {
+        std::uint64_t lo;
+        std::uint64_t hi = mul128(next(), n, lo);
+        if (lo < n) {
+            const std::uint64_t threshold = (0 - n) % n;
+            while (lo < threshold) hi = mul128(next(), n, lo);
+        }
+        return hi;
+    }
+
+    // Uniform in [0, 1) with 53 bits of precision.
+    double unit() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+
+    int i(int a, int b) {
+        const std::uint64_t span = static_cast<std::uint64_t>(static_cast<std::int64_t>(b) - a) + 1;
+        return static_cast<int>(a + static_cast<std::int64_t>(below(span)));
+    }
+    double f(double a, double b) { return a + (b - a) * unit(); }
+    bool chance(double p) { return unit() < p; }
+
+    // Bulk draws, same values as calling the scalar form n times.
+    void fill(int* out, std::size_t n, int a, int b) { for (std::size_t k = 0; k < n; ++k) out[k] = i(a, b); }
+    void fillUnit(double* out, std::size_t n)      { for (std::size_t k = 0; k < n; ++k) out[k] = unit(); }
+    void fillRaw(std::uint64_t* out, std::size_t n) { for (std::size_t k = 0; k < n; ++k) out[k] = next(); }
 };
 
-} // namespace core
\ No newline at end of file
+using FastRNG = BasicRNG<Xoshiro256ss>;
+using MtRNG   = BasicRNG<std::mt19937_64>;
+
+// Engine behind core::RNG; define OATHBOUND_RNG_MT19937 to use mt19937_64.
+#if defined(OATHBOUND_RNG_MT19937)
+using RNG = MtRNG;
+constexpr std::uint32_t kRngEngineId = 2;
+#else
+using RNG = FastRNG;
+constexpr std::uint32_t kRngEngineId = 1;
+#endif
+// kRngEngineId names the sequence core::RNG yields for a seed and is stored
+// in replays; give it a new value whenever the engine or the draw algorithms
+// above change.
+
+} // namespace core
@@ -0,0 +1,107 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace core {
+
+// Bounded single-producer/single-consumer queue. One thread may push while
+// another pops, without locks; each side keeps a cached copy of the other's
+// index so the shared atomics are only re-read when the ring looks full or
+// empty. Capacity is rounded up to a power of two.
+template<typename T>
+class SpscRing {
+public:
+    explicit SpscRing(std::size_t capacity = 1024) {
+        std::size_t n = 2;
+        while (n < capacity) n <<= 1;
+        buf_.resize(n);
+        mask_ = n - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer side. A full ring rejects the element and counts it in
+    // dropped() rather than blocking the caller.
+    bool push(const T& v) {
+        const std::size_t t = tail_.load(std::memory_order_relaxed);
+        if (t - headCache_ > mask_) {
+            headCache_ = head_.load(std::memory_order_acquire);
+            if (t - headCache_ > mask_) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        buf_[t & mask_] = v;
+        tail_.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side.
+    bool pop(T& out) {
+        const std::size_t h = head_.load(std::memory_order_relaxed);
+        if (h == tailCache_) {
+            tailCache_ = tail_.load(std::memory_order_acquire);
+            if (h == tailCache_) return false;
+        }
+        out = buf_[h & mask_];
+        head_.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: hands every queued element to f in order, returns the count.
+    template<typename F>
+    std::size_t drain(F&& f) {
+        const std::size_t h = head_.load(std::memory_order_relaxed);
+        const std::size_t t = tail_.load(std::memory_order_acquire);
+        tailCache_ = t;
+        for (std::size_t i = h; i != t; ++i) f(buf_[i & mask_]);
+        head_.store(t, std::memory_order_release);
+        return t - h;
+    }
+
+    std::size_t capacity() const { return mask_ + 1; }
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+    std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<T> buf_;
+    std::size_t mask_ = 0;
+
+    alignas(64) std::atomic<std::size_t> head_{0};   // next slot to pop, written by the consumer
+    std::size_t tailCache_ = 0;                      // consumer's view of tail_
+    alignas(64) std::atomic<std::size_t> tail_{0};   // next slot to push, written by the producer
+    std::size_t headCache_ = 0;                      // producer's view of head_
+    std::atomic<std::uint64_t> dropped_{0};
+};
+
+// Fixed-capacity history for a single thread: push() overwrites the oldest
+// element once full, [0] is the oldest kept and [size()-1] the newest.
+template<typename T>
+class HistoryRing {
+public:
+    explicit HistoryRing(std::size_t capacity = 512) : buf_(capacity ? capacity : 1) {}
+
+    void push(const T& v) {
+        buf_[(start_ + size_) % buf_.size()] = v;
+        if (size_ < buf_.size()) ++size_;
+        else start_ = (start_ + 1) % buf_.size();
+    }
+    void clear() { start_ = 0; size_ = 0; }
+
+    std::size_t size() const     { return size_; }
+    std::size_t capacity() const { return buf_.size(); }
+    bool empty() const           { return size_ == 0; }
+    const T& operator[](std::size_t i) const { return buf_[(start_ + i) % buf_.size()]; }
+
+private:
+    std::vector<T> buf_;
+    std::size_t start_ = 0;
+    std::size_t size_  = 0;
+};
+
+} // namespace core
@@ -1,21 +1,74 @@
 #pragma once
 #include <vector>
 #include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include "core/rng.hpp"
 
 namespace core {
 
+// Alias draw over the columns WeightedTable::build() produces; usable on
+// tables that live in mapped memory. n > 0.
+inline std::size_t aliasPick(const std::uint64_t* cut, const std::uint32_t* alias, std::size_t n, RNG& rng) {
+    // High half of u*n picks the column, low half is a uniform fraction
+    // compared against the column's cut.
+    std::uint64_t frac;
+    const std::uint64_t col = mul128(rng.next(), n, frac);
+    return frac < cut[col] ? static_cast<std::size_t>(col) : alias[col];
+}
+
+// Column cut for a scaled probability p (alias build step).
+constexpr std::uint64_t aliasCut(double p) {
+    return p >= 1.0 ? std::numeric_limits<std::uint64_t>::max()
+                    : static_cast<std::uint64_t>(p * 0x1.0p64);
+}
+
 template<typename T>
 class WeightedTable {
 public:
     void add(const T& t, double w) {
         if (w <= 0) return;
         items_.push_back(t);
+        weights_.push_back(w);
         total_ += w;
         prefix_.push_back(total_);
+        cut_.clear();   // alias table is stale until build()
+        alias_.clear();
+    }
+
+    // Compiles the Walker/Vose alias table. Afterwards pick() is O(1) and
+    // consumes one 64-bit draw; add() drops back to binary search until the
+    // next build().
+    void build() {
+        const std::size_t n = items_.size();
+        cut_.assign(n, std::numeric_limits<std::uint64_t>::max());
+        alias_.resize(n);
+        if (n == 0) return;
+
+        std::vector<double> p(n);
+        std::vector<std::uint32_t> small, large;
+        for (std::size_t i = 0; i < n; ++i) {
+            p[i] = weights_[i] * static_cast<double>(n) / total_;
+            alias_[i] = static_cast<std::uint32_t>(i);
+            (p[i] < 1.0 ? small : large).push_back(static_cast<std::uint32_t>(i));
+        }
+        while (!small.empty() && !large.empty()) {
+            const std::uint32_t s = small.back(); small.pop_back();
+            const std::uint32_t l = large.back();
+            cut_[s]   = aliasCut(p[s]);
+            alias_[s] = l;
+            p[l] = (p[l] + p[s]) - 1.0;
+            if (p[l] < 1.0) { large.pop_back(); small.push_back(l); }
+        }
+        // Leftovers are 1.0 up to rounding error and keep their full column.
     }
 
+    bool built() const { return !items_.empty() && cut_.size() == items_.size(); }
+
     const T& pick(core::RNG& rng) const {
+        if (built()) return items_[aliasPick(cut_.data(), alias_.data(), items_.size(), rng)];
         double r = rng.f(0.0, total_);
         auto it = std::lower_bound(prefix_.begin(), prefix_.end(), r);
         size_t idx = static_cast<size_t>(std::distance(prefix_.begin(), it));
@@ -23,11 +76,74 @@ public:
     }
 
     bool empty() const { return items_.empty(); }
+    std::size_t size() const { return items_.size(); }
+
+    // Raw columns, for serialising a built table.
+    const std::vector<T>&             items() const   { return items_; }
+    const std::vector<double>&        weights() const { return weights_; }
+    const std::vector<std::uint64_t>& cuts() const    { return cut_; }
+    const std::vector<std::uint32_t>& aliases() const { return alias_; }
 
 private:
     std::vector<T> items_;
+    std::vector<double> weights_;
     std::vector<double> prefix_;
+    std::vector<std::uint64_t> cut_;
+    std::vector<std::uint32_t> alias_;
     double total_ = 0.0;
 };
 
-} // namespace core
\ No newline at end of file
+template<typename T>
+struct Weighted {
+    T      item;
+    double weight;   // > 0
+};
+
+// WeightedTable over a fixed set of N entries whose alias table is built by
+// the constexpr constructor, so a constexpr instance lives in read-only data
+// and needs no setup. Same columns, and so the same picks, as a WeightedTable
+// given the entries in order; N is a constant in pick().
+template<typename T, std::size_t N>
+class FixedWeightedTable {
+    static_assert(N > 0, "FixedWeightedTable needs at least one entry");
+public:
+    constexpr explicit FixedWeightedTable(const Weighted<T> (&entries)[N]) : items_{}, cut_{}, alias_{} {
+        double total = 0.0;
+        for (std::size_t i = 0; i < N; ++i) {
+            items_[i] = entries[i].item;
+            total += entries[i].weight;
+        }
+
+        // Mirrors WeightedTable::build(), including its stack order.
+        double p[N] = {};
+        std::uint32_t small[N] = {}, large[N] = {};
+        std::size_t ns = 0, nl = 0;
+        for (std::size_t i = 0; i < N; ++i) {
+            p[i] = entries[i].weight * static_cast<double>(N) / total;
+            cut_[i] = std::numeric_limits<std::uint64_t>::max();
+            alias_[i] = static_cast<std::uint32_t>(i);
+            if (p[i] < 1.0) small[ns++] = static_cast<std::uint32_t>(i);
+            else            large[nl++] = static_cast<std::uint32_t>(i);
+        }
+        while (ns > 0 && nl > 0) {
+            const std::uint32_t s = small[--ns];
+            const std::uint32_t l = large[nl - 1];
+            cut_[s]   = aliasCut(p[s]);
+            alias_[s] = l;
+            p[l] = (p[l] + p[s]) - 1.0;
+            if (p[l] < 1.0) { --nl; small[ns++] = l; }
+        }
+    }
+
+    const T& pick(RNG& rng) const { return items_[aliasPick(cut_.data(), alias_.data(), N, rng)]; }
+
+    static constexpr std::size_t size() { return N; }
+    constexpr const T& operator[](std::size_t i) const { return items_[i]; }
+
+private:
+    std::array<T, N>             items_;
+    std::array<std::uint64_t, N> cut_;
+    std::array<std::uint32_t, N> alias_;
+};
+
+} // namespace core
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+
+namespace core {
+
+// SplitMix64 step; advances x and returns a well-mixed 64-bit value.
+inline std::uint64_t splitmix64(std::uint64_t& x) {
+    std::uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// xoshiro256** (Blackman & Vigna). 32 bytes of state instead of the 2.5KB of
+// mt19937_64, a handful of ALU ops per draw, and usable as a standard
+// UniformRandomBitGenerator.
+struct Xoshiro256ss {
+    using result_type = std::uint64_t;
+
+    std::uint64_t s[4];
+
+    explicit Xoshiro256ss(std::uint64_t seed = 0) {
+        std::uint64_t x = seed;
+        for (auto& w : s) w = splitmix64(x);
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type(0); }
+
+    result_type operator()() {
+        const std::uint64_t result = rotl(s[1] * 5, 7) * 9;
+        const std::uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+private:
+    static std::uint64_t rotl(std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+};
+
+} // namespace core
@@ -1,19 +1,39 @@
 #pragma once
+#include <cstddef>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include "game/item.hpp"
 #include "core/rng.hpp"
 
 namespace game {
 
+// Allocator-aware like Item: name and weapon use the given resource.
 struct Actor {
-    std::string name;
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    std::pmr::string name;
     int maxHP = 1;
     int hp    = 1;
     int armor = 0;        // flat reduction (includes gear bonuses)
     Item weapon;          // ItemKind::Weapon expected
 
+    Actor() = default;
+    Actor(std::string_view name, int maxHP, int hp, int armor, Item weapon = Item{},
+          const allocator_type& a = {})
+        : name(name, a), maxHP(maxHP), hp(hp), armor(armor), weapon(std::move(weapon), a) {}
+    explicit Actor(const allocator_type& a) : name(a), weapon(a) {}
+    Actor(const Actor&) = default;
+    Actor(Actor&&) = default;
+    Actor(const Actor& o, const allocator_type& a) : name(a), weapon(a) { *this = o; }
+    Actor(Actor&& o, const allocator_type& a) : name(a), weapon(a) { *this = std::move(o); }
+    Actor& operator=(const Actor&) = default;
+    Actor& operator=(Actor&&) = default;
+
     bool alive() const { return hp > 0; }
-    int  attack(Actor& target, core::RNG& rng, double extraPct=0.0, double extraCrit=0.0) const;
+    // Damage after target armor; `crit`, if given, reports the crit roll.
+    int  attack(Actor& target, core::RNG& rng, double extraPct=0.0, double extraCrit=0.0,
+                bool* crit=nullptr) const;
 };
 
 } // namespace game
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "core/rng.hpp"
+#include "game/actor.hpp"
+#include "game/item.hpp"
+
+namespace game {
+
+class ActorStore;
+
+// Read-only handle to one stored actor, for frontends that want Actor-like
+// access without copying it out.
+class ActorView {
+public:
+    ActorView(const ActorStore& s, std::uint32_t id) : s_(&s), id_(id) {}
+    std::uint32_t      id() const { return id_; }
+    const std::string& name() const;
+    const Item&        weapon() const;
+    int  hp() const;
+    int  maxHP() const;
+    int  armor() const;
+    bool alive() const { return hp() > 0; }
+
+private:
+    const ActorStore* s_;
+    std::uint32_t id_;
+};
+
+// Entity/component storage for mass battles. Living actors are kept densely
+// packed, column per stat (hp, armor, swings per round and the resolved
+// SwingProfile of their weapon), so a phase over them is a straight loop over
+// contiguous arrays. A death swap-removes the actor from the dense columns in
+// O(1); ids stay valid and names, weapons and final hp remain readable through
+// view() / toActor().
+class ActorStore {
+public:
+    std::uint32_t add(const Actor& a);          // returns the actor's id
+    std::size_t   size() const       { return names_.size(); }
+    std::size_t   aliveCount() const { return dense_.size(); }
+
+    ActorView view(std::uint32_t id) const { return ActorView(*this, id); }
+    Actor     toActor(std::uint32_t id) const;
+    bool      alive(std::uint32_t id) const { return slot_[id] != kDead; }
+    int       hp(std::uint32_t id) const;
+
+    // Living actors in dense order; ids change position as others die.
+    const std::vector<std::uint32_t>& aliveIds() const { return dense_; }
+
+    // Subtracts dmg from a living actor, removing it when it drops to 0.
+    // Returns the hp left.
+    int damage(std::uint32_t id, int dmg);
+
+    // Every living actor takes all its swings for a round at one target with
+    // `targetArmor`; returns the summed damage after armor. Each swing slot
+    // (up to the most swings any actor has) fills two uniform draws per
+    // living actor in bulk, base roll and crit, so the damage itself is a
+    // branch-free pass over the columns, with damageBatch() doing the
+    // scale, crit and rounding. Base rolls take floor(u * span) rather than
+    // RNG::i(), so the draws are not those of Actor::attack.
+    std::int64_t attackPhase(core::RNG& rng, int targetArmor);
+
+private:
+    friend class ActorView;
+    static constexpr std::uint32_t kDead = 0xFFFFFFFFu;
+
+    void remove(std::uint32_t id);
+
+    // Dense, living only; index = slot.
+    std::vector<std::uint32_t> dense_;   // slot -> id
+    std::vector<int>    hp_, armor_, hits_, minDmg_, span_;
+    std::vector<double> scale_, critC_, critMult_;
+
+    // Sparse, every id.
+    std::vector<std::uint32_t> slot_;    // id -> slot, kDead once removed
+    std::vector<std::string>   names_;
+    std::vector<Item>          weapons_;
+    std::vector<int>           maxHP_, baseArmor_, finalHp_;
+
+    std::vector<double> draws_;          // attackPhase scratch
+    std::vector<int>    rolls_;
+};
+
+} // namespace game
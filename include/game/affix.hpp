@@ -1,4 +1,9 @@
 #pragma once
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <string>
 
 namespace game {
@@ -19,4 +24,84 @@ struct Affix {
     }
 };
 
-} // namespace game
\ No newline at end of file
+// Compact handle to an Affix definition in the AffixRegistry. kNoAffix is
+// never handed out, so it can mark an empty or failed entry.
+using AffixId = std::uint16_t;
+inline constexpr AffixId kNoAffix = 0xFFFF;
+
+// Process-wide table of affix definitions. Items only store ids; names and
+// stats are looked up here. Register content while loading, before any
+// threads start reading: lookups are unsynchronised.
+class AffixRegistry {
+public:
+    static constexpr std::size_t kMaxAffixes = kNoAffix;   // ids 0..kNoAffix-1
+
+    // Id of an identical existing definition, or a newly registered one;
+    // kNoAffix once kMaxAffixes definitions are registered.
+    AffixId intern(const Affix& a);
+    const Affix& get(AffixId id) const { return defs_[id]; }
+    std::size_t size() const { return defs_.size(); }
+
+    static AffixRegistry& global();
+
+private:
+    std::deque<Affix> defs_; // deque: references stay valid as it grows
+};
+
+inline AffixId internAffix(const Affix& a) { return AffixRegistry::global().intern(a); }
+inline const Affix& affixDef(AffixId id)   { return AffixRegistry::global().get(id); }
+
+// Summed stats of a set of affixes.
+struct AffixTotals {
+    int    flatMin     = 0;
+    int    flatMax     = 0;
+    double pctDamage   = 0.0;
+    double critChance  = 0.0;
+    double attackSpeed = 0.0;
+};
+
+// Inline, fixed-capacity list of affix ids (Legendary rolls the most: 2+2).
+// Totals are updated on every push_back/clear, so stat queries never walk
+// the list; the ids can't be changed any other way. push_back's scale
+// multiplies that affix's stats on this item only (flat values rounded),
+// which lets tuned loot vary affixes without registering new ones.
+class AffixList {
+public:
+    static constexpr std::size_t kCapacity = 4;
+
+    bool push_back(AffixId id, double scale = 1.0) {
+        if (n_ == kCapacity) return false;
+        ids_[n_++] = id;
+        const Affix& a = affixDef(id);
+        if (scale == 1.0) {
+            totals_.flatMin     += a.flatMin;
+            totals_.flatMax     += a.flatMax;
+            totals_.pctDamage   += a.pctDamage;
+            totals_.critChance  += a.critChance;
+            totals_.attackSpeed += a.attackSpeed;
+        } else {
+            totals_.flatMin     += static_cast<int>(std::lround(a.flatMin * scale));
+            totals_.flatMax     += static_cast<int>(std::lround(a.flatMax * scale));
+            totals_.pctDamage   += a.pctDamage * scale;
+            totals_.critChance  += a.critChance * scale;
+            totals_.attackSpeed += a.attackSpeed * scale;
+        }
+        return true;
+    }
+    void clear() { n_ = 0; totals_ = AffixTotals{}; }
+
+    const AffixTotals& totals() const { return totals_; }
+
+    std::size_t size() const { return n_; }
+    bool empty() const { return n_ == 0; }
+    AffixId operator[](std::size_t i) const { return ids_[i]; }
+    const AffixId* begin() const { return ids_.data(); }
+    const AffixId* end() const   { return ids_.data() + n_; }
+
+private:
+    AffixTotals totals_;
+    std::array<AffixId, kCapacity> ids_{};
+    std::uint8_t n_ = 0;
+};
+
+} // namespace game
@@ -0,0 +1,60 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "core/rng.hpp"
+#include "core/weighted_table.hpp"
+#include "game/affix.hpp"
+
+namespace game {
+
+// One rollable tier of an affix: eligible from minLevel to maxLevel
+// inclusive, drawn in proportion to weight among the tiers eligible at the
+// item level.
+struct AffixTier {
+    AffixId       affix    = 0;
+    double        weight   = 1.0;
+    int           minLevel = 1;
+    int           maxLevel = 100;
+    std::uint16_t group    = 0;   // tiers sharing a group never roll on the same item
+    double        scale    = 1.0; // applied to the affix's stats when rolled
+};
+
+// Level-gated, weighted prefix or suffix pool. build() cuts levels
+// 1..kMaxLevel into bands wherever some tier starts or stops being eligible
+// and compiles one alias table per band, so a roll is a table lookup plus
+// O(1) draws however many tiers and levels there are.
+class AffixPool {
+public:
+    static constexpr int kMaxLevel = 100;   // higher item levels roll as kMaxLevel
+
+    // Tiers of affixes with the same name share a group: one item gets at
+    // most one tier of "Jagged". Non-positive or non-finite weights and
+    // kNoAffix are ignored. `scale` multiplies the affix's stats on items
+    // this tier rolls onto (see AffixList::push_back).
+    void add(AffixId affix, double weight = 1.0, int minLevel = 1, int maxLevel = kMaxLevel,
+             double scale = 1.0);
+    void build();   // compile per-level tables after edits
+
+    // Appends up to `count` affixes eligible at `level` to `out`, never two
+    // from one group. Fewer when the level has fewer groups or `out` fills up.
+    void roll(core::RNG& rng, int level, int count, AffixList& out) const;
+
+    bool empty() const { return tiers_.empty(); }
+    std::size_t size() const { return tiers_.size(); }
+    const std::vector<AffixTier>& tiers() const { return tiers_; }
+
+private:
+    struct Band {
+        core::WeightedTable<std::uint32_t> table;   // indices into tiers_
+        int groups = 0;                             // distinct groups eligible
+    };
+
+    std::vector<AffixTier> tiers_;
+    std::vector<Band> bands_;
+    std::array<std::uint16_t, kMaxLevel + 1> bandOfLevel_{};
+    std::uint16_t nextGroup_ = 0;
+};
+
+} // namespace game
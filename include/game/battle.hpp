@@ -0,0 +1,73 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "core/rng.hpp"
+#include "game/actor.hpp"
+#include "game/combat_event.hpp"
+#include "game/combat_math.hpp"
+
+namespace game {
+
+enum class BattleOutcome { AlliesWin, EnemiesWin, Timeout };
+
+struct BattleResult {
+    BattleOutcome outcome = BattleOutcome::Timeout;
+    double        time    = 0.0;   // in rounds, of the last swing
+    std::uint64_t swings  = 0;
+    std::size_t   alliesAlive  = 0;
+    std::size_t   enemiesAlive = 0;
+};
+
+// Timeline combat between two sides of any size. Every actor swings every
+// 1 / expectedAPS(weapon) rounds, so fractional attack speed is exact rather
+// than rounded to whole swings per round. Swings are taken from a min-heap
+// keyed by (time, actor id); an attacker keeps its target until it dies, then
+// picks a random living opponent. Each side keeps its living actors in a
+// swap-remove list, so deaths and retargeting are O(1) and a swing is
+// O(log actors) however large the battle.
+//
+// Actor ids: allies are 0..A-1 and enemy i is A + i, which with one ally
+// matches kPlayerActor / enemyActor() and CombatRoster::of(). Events carry
+// 16-bit ids, so only battles under 0xFFFF actors can be logged.
+class Battle {
+public:
+    Battle(const std::vector<Actor>& allies, const std::vector<Actor>& enemies);
+
+    // Fights until one side is dead or the next swing falls after `maxRounds`.
+    // `events` (optional) receives Hit/Slain and a final Victory/Defeat, with
+    // round = the 1-based round the swing falls in. Battles of kNoActor or
+    // more actors run unlogged, since their ids don't fit the event fields.
+    BattleResult run(core::RNG& rng, double maxRounds = 200.0, CombatEventRing* events = nullptr);
+
+    int  hp(std::size_t id) const    { return fighters_[id].hp; }
+    bool alive(std::size_t id) const { return fighters_[id].hp > 0; }
+    std::size_t size() const         { return fighters_.size(); }
+
+private:
+    struct Fighter {
+        int           hp;
+        int           armor;
+        SwingProfile  swing;
+        double        interval;   // rounds between swings
+        std::uint64_t swings = 0;
+        std::uint32_t target = kNone;
+        std::uint32_t slot   = 0;   // position in alive_[side]
+        std::uint8_t  side   = 0;   // 0 = allies, 1 = enemies
+    };
+    struct Turn {
+        double        time;
+        std::uint32_t id;
+        bool operator>(const Turn& o) const { return time != o.time ? time > o.time : id > o.id; }
+    };
+    static constexpr std::uint32_t kNone = 0xFFFFFFFFu;
+
+    void add(const Actor& a, std::uint8_t side);
+    void kill(std::uint32_t id);
+
+    std::vector<Fighter> fighters_;
+    std::vector<std::uint32_t> alive_[2];
+    std::vector<Turn> heap_;
+};
+
+} // namespace game
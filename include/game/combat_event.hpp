@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include "core/spsc_ring.hpp"
+#include "game/actor.hpp"
+
+namespace game {
+
+class Inventory;
+
+enum class CombatEventKind : std::uint8_t {
+    RoundStart,   // round
+    Hit,          // attacker, target, damage, hpAfter, flags
+    Slain,        // target
+    Drop,         // dropId (weapon index, or gear index with kEventGear)
+    AutoEquip,    // dropId: weapon index now in the main hand
+    Victory,      // hpAfter = player hp
+    Defeat,
+};
+
+// Actor ids: the player is 0, enemy i is i + 1.
+constexpr std::uint16_t kPlayerActor = 0;
+constexpr std::uint16_t kNoActor     = 0xFFFF;
+constexpr std::uint32_t kNoDrop      = 0xFFFFFFFFu;
+inline std::uint16_t enemyActor(std::size_t i) { return static_cast<std::uint16_t>(i + 1); }
+
+constexpr std::uint8_t kEventCrit    = 1u << 0;
+constexpr std::uint8_t kEventOffhand = 1u << 1;
+constexpr std::uint8_t kEventGear    = 1u << 2;
+
+// One combat fact in 24 bytes, no strings. Emitting it is a store into a
+// ring; text is produced only by consumers that display it.
+struct CombatEvent {
+    std::uint32_t   round    = 0;
+    CombatEventKind kind     = CombatEventKind::Hit;
+    std::uint8_t    flags    = 0;
+    std::uint16_t   attacker = kNoActor;
+    std::uint16_t   target   = kNoActor;
+    std::int32_t    damage   = 0;
+    std::int32_t    hpAfter  = 0;
+    std::uint32_t   dropId   = kNoDrop;
+};
+static_assert(sizeof(CombatEvent) == 24, "CombatEvent is meant to stay compact");
+
+using CombatEventRing = core::SpscRing<CombatEvent>;
+
+// Names and max HP per actor id, captured at the start of a battle so events
+// can be formatted after the actors have changed or gone.
+struct CombatRoster {
+    std::vector<std::string> names;
+    std::vector<int>         maxHP;
+
+    static CombatRoster of(const Actor& player, const std::vector<Actor>& enemies);
+};
+
+// Renders one event as a log line. `inv` resolves drop ids; without it drops
+// are shown by index.
+void formatEvent(std::ostream& os, const CombatEvent& e, const CombatRoster& roster,
+                 const Inventory* inv = nullptr);
+std::string formatEvent(const CombatEvent& e, const CombatRoster& roster, const Inventory* inv = nullptr);
+
+} // namespace game
@@ -24,16 +24,54 @@ inline double expectedAPS(const Item& w, double extraAS=0.0) {
     return std::max(0.2, 1.0 + w.attackSpeed() + extraAS);
 }
 
+// Whole swings a weapon lands in one simulated round; at least one.
+inline int swingsPerRound(const Item& w) {
+    return std::max(1, static_cast<int>(std::round(w.attackSpeed())));
+}
+
 inline double expectedDPR(const Item& w, double extraPct=0.0, double extraCrit=0.0, double extraAS=0.0) {
     return expectedDamagePerSwing(w, extraPct, extraCrit) * expectedAPS(w, extraAS);
 }
 
-inline int rollDamageWithBonuses(const Item& w, core::RNG& rng, double extraPct=0.0, double extraCrit=0.0) {
-    int baseRoll   = rng.i(w.minDmg(), w.maxDmg());
-    double scaled  = baseRoll * (1.0 + w.pctDamage() + extraPct);
-    double critC   = std::clamp(w.critChance() + extraCrit, 0.0, 0.95);
-    if (rng.chance(critC)) scaled *= w.critMult();
+// Inputs of one damage roll, resolved once per weapon + bonus combination so
+// hot loops don't re-sum affixes every swing.
+struct SwingProfile {
+    int    minDmg   = 1;
+    int    maxDmg   = 1;
+    double scale    = 1.0;  // 1 + weapon pct + extra pct
+    double critC    = 0.0;  // clamped to [0, 0.95]
+    double critMult = 1.5;
+};
+
+inline SwingProfile makeSwingProfile(const Item& w, double extraPct=0.0, double extraCrit=0.0) {
+    SwingProfile p;
+    p.minDmg   = w.minDmg();
+    p.maxDmg   = w.maxDmg();
+    p.scale    = 1.0 + w.pctDamage() + extraPct;
+    p.critC    = std::clamp(w.critChance() + extraCrit, 0.0, 0.95);
+    p.critMult = w.critMult();
+    return p;
+}
+
+// Same draws as rollDamage(p, rng); `crit` reports whether the crit roll hit.
+inline int rollDamage(const SwingProfile& p, core::RNG& rng, bool& crit) {
+    int baseRoll   = rng.i(p.minDmg, p.maxDmg);
+    double scaled  = baseRoll * p.scale;
+    crit = rng.chance(p.critC);
+    if (crit) scaled *= p.critMult;
     return std::max(0, static_cast<int>(std::round(scaled)));
 }
 
+inline int rollDamage(const SwingProfile& p, core::RNG& rng) {
+    bool crit;
+    return rollDamage(p, rng, crit);
+}
+
+inline int rollDamageWithBonuses(const Item& w, core::RNG& rng, double extraPct=0.0, double extraCrit=0.0) {
+    return rollDamage(makeSwingProfile(w, extraPct, extraCrit), rng);
+}
+
+// Flat armor reduction applied by Actor::attack.
+inline int applyArmor(int dmg, int armor) { return std::max(0, dmg - armor); }
+
 } // namespace game
\ No newline at end of file
@@ -0,0 +1,136 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <string_view>
+#include "core/rng.hpp"
+#include "game/rarity.hpp"
+#include "game/slots.hpp"
+
+namespace game {
+
+struct LootTables;
+
+// Compiled loot content, laid out so a mapped file is used in place: fixed
+// size little-endian records, one string blob, and for every weighted table
+// the weights plus the alias columns WeightedTable::build() would compute.
+// All offsets are from the start of the file and 8-byte aligned.
+
+struct PackString {
+    std::uint32_t offset = 0;   // into the string blob
+    std::uint32_t length = 0;
+};
+
+struct PackWeaponBase {
+    PackString   name;
+    std::int32_t baseMin = 0;
+    std::int32_t baseMax = 0;
+};
+
+struct PackGearBase {
+    PackString    name;
+    std::uint32_t slot = 0;     // game::Slot
+    std::int32_t  armorMin = 0;
+    std::int32_t  armorMax = 0;
+    std::uint32_t pad = 0;
+};
+
+struct PackAffix {
+    PackString   name;
+    std::int32_t flatMin     = 0;
+    std::int32_t flatMax     = 0;
+    double       pctDamage   = 0.0;
+    double       critChance  = 0.0;
+    double       attackSpeed = 0.0;
+    double       weight      = 1.0;   // AffixTier
+    std::int32_t minLevel    = 1;
+    std::int32_t maxLevel    = 100;
+};
+
+// A weighted table: `count` records plus parallel weight/cut/alias columns.
+struct PackTable {
+    std::uint64_t records = 0;
+    std::uint64_t weights = 0;  // double[count]
+    std::uint64_t cuts    = 0;  // u64[count]
+    std::uint64_t aliases = 0;  // u32[count]
+    std::uint32_t count   = 0;
+    std::uint32_t pad     = 0;
+};
+
+struct PackRange {
+    std::uint64_t offset = 0;
+    std::uint32_t count  = 0;   // records, or bytes for the string blob
+    std::uint32_t pad    = 0;
+};
+
+struct PackHeader {
+    static constexpr std::uint16_t kVersion   = 2;
+    static constexpr std::uint16_t kByteOrder = 0x0102;
+
+    char          magic[4] = {'O', 'B', 'P', 'K'};
+    std::uint16_t version   = kVersion;
+    std::uint16_t byteOrder = kByteOrder;   // reads back as 0x0201 on a big-endian host
+    std::uint64_t fileSize  = 0;
+    PackTable dropType;     // u32 records: 0 = weapon, 1 = gear
+    PackTable rarity;       // u32 records: game::Rarity
+    PackTable weaponBases;  // PackWeaponBase
+    PackTable gearBases;    // PackGearBase
+    PackRange prefixes;     // PackAffix, one per AffixPool tier
+    PackRange suffixes;     // PackAffix, one per AffixPool tier
+    PackRange strings;
+};
+
+// Read-only mapping of a content pack. Opening checks the header, that every
+// range lies inside the file and that every alias and string reference is in
+// bounds; after that draws are plain loads from the mapping.
+class ContentPack {
+public:
+    static std::shared_ptr<const ContentPack> open(const std::string& path);   // null on failure
+    ~ContentPack();
+    ContentPack(const ContentPack&) = delete;
+    ContentPack& operator=(const ContentPack&) = delete;
+
+    const PackHeader& header() const { return *reinterpret_cast<const PackHeader*>(base_); }
+
+    template<typename T>
+    const T* records(const PackTable& t) const { return at<T>(t.records); }
+    template<typename T>
+    const T* records(const PackRange& r) const { return at<T>(r.offset); }
+    const double* weights(const PackTable& t) const { return at<double>(t.weights); }
+    std::string_view str(PackString s) const {
+        return std::string_view(at<char>(header().strings.offset) + s.offset, s.length);
+    }
+
+    // Same draws as the WeightedTable picks in LootTables.
+    int                   pickDropType(core::RNG& rng) const;
+    Rarity                pickRarity(core::RNG& rng) const;
+    const PackWeaponBase& pickWeaponBase(core::RNG& rng) const;
+    const PackGearBase&   pickGearBase(core::RNG& rng) const;
+
+private:
+    ContentPack() = default;
+    bool validate() const;
+
+    template<typename T>
+    const T* at(std::uint64_t offset) const { return reinterpret_cast<const T*>(base_ + offset); }
+    std::size_t pick(const PackTable& t, core::RNG& rng) const;
+
+    const unsigned char* base_ = nullptr;
+    std::size_t size_ = 0;
+    void* mapping_ = nullptr;   // platform handle kept for unmapping
+};
+
+// Serialises built, in-memory tables (not pack-backed or builtin ones);
+// false if any of dropType/rarity/bases/gearBases is empty or unbuilt.
+bool writeContentPack(std::ostream& os, const LootTables& lt);
+bool saveContentPack(const std::string& path, const LootTables& lt);
+
+// Maps `path` and points `out` at it: dropType/rarity/bases/gearBases stay
+// empty and every roll reads the pack. Only the affix pools are rebuilt,
+// because items refer to affixes by registry id; false, leaving `out`
+// untouched, if the pack is invalid or its affixes don't fit the registry.
+bool openContentPack(const std::string& path, LootTables& out);
+
+} // namespace game
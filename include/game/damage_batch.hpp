@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include "core/rng.hpp"
+#include "game/combat_math.hpp"
+
+namespace game {
+
+// Batch form of rollDamage(): the random inputs are drawn first, then a
+// kernel turns them into damage many swings at a time. For every swing
+//   out = max(0, round(base * scale * (critU < critC ? critMult : 1)))
+// with round() rounding halves away from zero like std::round, so results
+// are identical to rollDamage() given the same base roll and crit draw.
+//
+// The AVX2 kernel does four swings per instruction and is picked at run time
+// on x86 CPUs that have it; everywhere else the scalar loop runs.
+enum class DamageKernel { Scalar, Avx2 };
+
+DamageKernel bestDamageKernel();
+
+// Per-attacker profile columns for the one-swing-each form.
+struct SwingColumns {
+    const double* scale;
+    const double* critC;
+    const double* critMult;
+};
+
+// n swings of one weapon: base[k] in [p.minDmg, p.maxDmg], critU[k] in [0, 1).
+void damageBatch(const SwingProfile& p, const int* base, const double* critU, int* out, std::size_t n,
+                 DamageKernel k = bestDamageKernel());
+// One swing for each of n attackers, attacker k's profile in column k.
+void damageBatch(const SwingColumns& c, const int* base, const double* critU, int* out, std::size_t n,
+                 DamageKernel k = bestDamageKernel());
+
+// Same draws and results as n calls of rollDamage(p, rng).
+void rollDamageBatch(const SwingProfile& p, core::RNG& rng, int* out, std::size_t n);
+
+} // namespace game
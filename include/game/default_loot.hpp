@@ -0,0 +1,107 @@
+#pragma once
+#include <string_view>
+#include "core/weighted_table.hpp"
+#include "game/affix_pool.hpp"
+#include "game/rarity.hpp"
+#include "game/slots.hpp"
+
+namespace game {
+
+// The built-in loot content as constexpr data: the alias tables are built by
+// the compiler and live in read-only memory. makeDefaultLoot() points a
+// LootTables at these; content/default_loot.txt holds the same tables for
+// oathbound_packc.
+namespace default_loot {
+
+struct WeaponBaseDef {
+    std::string_view name;
+    int baseMin = 1;
+    int baseMax = 1;
+};
+
+struct GearBaseDef {
+    Slot             slot = Slot::Armor;
+    std::string_view name;
+    int armorMin = 0;
+    int armorMax = 0;
+};
+
+struct AffixTierDef {
+    std::string_view name;
+    int    flatMin     = 0;
+    int    flatMax     = 0;
+    double pctDamage   = 0.0;
+    double critChance  = 0.0;
+    double attackSpeed = 0.0;
+    double weight      = 1.0;
+    int    minLevel    = 1;
+    int    maxLevel    = AffixPool::kMaxLevel;
+};
+
+// Entries in table order, then the compiled tables; makeEditableDefaultLoot()
+// builds ordinary WeightedTables from the same entries.
+inline constexpr core::Weighted<int> kDropTypeEntries[] = {
+    {0, 70},   // weapon
+    {1, 30},   // gear
+};
+inline constexpr core::FixedWeightedTable<int, 2> kDropType{kDropTypeEntries};
+
+inline constexpr core::Weighted<Rarity> kRarityEntries[] = {
+    {Rarity::Common,    60},
+    {Rarity::Magic,     25},
+    {Rarity::Rare,      10},
+    {Rarity::Epic,       4},
+    {Rarity::Legendary,  1},
+};
+inline constexpr core::FixedWeightedTable<Rarity, 5> kRarity{kRarityEntries};
+
+inline constexpr core::Weighted<WeaponBaseDef> kWeaponBaseEntries[] = {
+    {{"Shortsword", 3, 7},  25},
+    {{"Longsword",  5, 11}, 25},
+    {{"Axe",        6, 13}, 20},
+    {{"Mace",       7, 12}, 15},
+    {{"Spear",      4, 10}, 15},
+};
+inline constexpr core::FixedWeightedTable<WeaponBaseDef, 5> kWeaponBases{kWeaponBaseEntries};
+
+inline constexpr core::Weighted<GearBaseDef> kGearBaseEntries[] = {
+    {{Slot::Offhand, "Wooden Shield",    1, 3}, 18},
+    {{Slot::Offhand, "Bronze Shield",    2, 5}, 12},
+    {{Slot::Armor,   "Leather Armor",    2, 5}, 22},
+    {{Slot::Armor,   "Chainmail",        3, 7}, 12},
+    {{Slot::Helmet,  "Cloth Hood",       0, 2}, 18},
+    {{Slot::Helmet,  "Iron Helm",        1, 3}, 12},
+    {{Slot::Boots,   "Traveler's Boots", 0, 2}, 20},
+    {{Slot::Boots,   "Greaves",          1, 3}, 10},
+    {{Slot::Belt,    "Rope Belt",        0, 0}, 16},
+    {{Slot::Belt,    "Studded Belt",     0, 1}, 10},
+    {{Slot::Amulet,  "Amulet",           0, 0}, 18},
+    {{Slot::Ring1,   "Copper Ring",      0, 0}, 18},
+    {{Slot::Ring1,   "Silver Ring",      0, 0}, 12},
+};
+inline constexpr core::FixedWeightedTable<GearBaseDef, 13> kGearBases{kGearBaseEntries};
+
+// Base tiers roll at every level; stronger tiers of the same affix join from
+// their minimum level and never stack with the base one.
+inline constexpr AffixTierDef kPrefixes[] = {
+    {"Jagged", 1, 2, 0.00, 0.00,  0.00},
+    {"Heavy",  2, 4, 0.10, 0.00, -0.05},
+    {"Keen",   0, 0, 0.00, 0.05,  0.00},
+    {"Swift",  0, 0, 0.00, 0.00,  0.15},
+    {"Brutal", 2, 3, 0.20, 0.02, -0.05},
+    {"Jagged", 3, 5, 0.00, 0.00,  0.00, 0.6, 15},
+    {"Keen",   0, 0, 0.00, 0.09,  0.00, 0.5, 25},
+};
+
+inline constexpr AffixTierDef kSuffixes[] = {
+    {"of Embers",  0, 0, 0.12, 0.00,  0.00},
+    {"of Frost",   0, 0, 0.10, 0.02,  0.00},
+    {"of Haste",   0, 0, 0.00, 0.00,  0.20},
+    {"of Slaying", 1, 2, 0.08, 0.03,  0.00},
+    {"of Mauling", 3, 3, 0.00, 0.00, -0.05},
+    {"of Embers",  0, 0, 0.20, 0.00,  0.00, 0.5, 20},
+    {"of Haste",   0, 0, 0.00, 0.00,  0.30, 0.4, 30},
+};
+
+} // namespace default_loot
+} // namespace game
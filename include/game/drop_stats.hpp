@@ -0,0 +1,103 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "core/quantile_sketch.hpp"
+#include "game/affix.hpp"
+#include "game/combat_event.hpp"
+#include "game/item.hpp"
+#include "game/rarity.hpp"
+
+namespace game {
+
+// Streaming aggregate of drops and combat, in memory fixed at construction,
+// so studies over billions of drops never keep the items. Tracks
+//   - drops per rarity and kind, and per (kind, rarity, base, affix set)
+//     combination in a table of at most `maxCombos` entries;
+//   - kills, so each combination's expected kills per drop is kills / count;
+//   - sketches of damage dealt and taken and of dropped weapons' DPR.
+// Affix sets ignore roll order. Once the table is full, drops of unseen
+// combinations are only counted in otherDrops().
+//
+// Per-thread instances merge exactly (all counts are integer sums) as long
+// as no table overflowed; the export order is by count, then key.
+class DropStats {
+public:
+    static constexpr std::size_t kRarities = 5;
+
+    explicit DropStats(std::size_t maxCombos = 16384);
+
+    // Sinks. addDrop() reads the item and keeps nothing of it.
+    void addDrop(const Item& it);
+    void addKills(std::uint64_t n = 1)  { kills_ += n; }
+    void addDealt(int dmg)              { dealt_.add(dmg); }
+    void addTaken(int dmg)              { taken_.add(dmg); }
+    // Hit feeds dealt/taken by attacker, Slain of an enemy counts a kill;
+    // Drop events carry only an index, so drops go through addDrop().
+    void addEvent(const CombatEvent& e);
+
+    void merge(const DropStats& o);
+
+    struct Combo {
+        ItemKind    kind;
+        Rarity      rarity;
+        std::string base;
+        std::vector<AffixId> affixes;   // ascending
+        std::uint64_t count;
+    };
+    // Every tracked combination, most frequent first.
+    std::vector<Combo> combos() const;
+
+    std::uint64_t drops() const      { return drops_; }
+    std::uint64_t kills() const      { return kills_; }
+    std::uint64_t otherDrops() const { return otherDrops_; }
+    std::uint64_t drops(Rarity r) const { return byRarity_[static_cast<std::size_t>(r)]; }
+    std::uint64_t drops(ItemKind k) const { return byKind_[k == ItemKind::Gear ? 1 : 0]; }
+    std::size_t   comboCount() const { return used_; }
+    std::size_t   maxCombos() const  { return maxCombos_; }
+
+    const core::QuantileSketch& dealt() const     { return dealt_; }
+    const core::QuantileSketch& taken() const     { return taken_; }
+    const core::QuantileSketch& weaponDPR() const { return weaponDPR_; }
+
+    // CSV: one row per combination. JSON: totals, sketch summaries with
+    // their non-empty bins, and the combinations.
+    void writeCsv(std::ostream& os) const;
+    void writeJson(std::ostream& os) const;
+
+private:
+    // Combination key: 12 bytes, compared and hashed as a whole.
+    struct Key {
+        std::uint16_t base    = 0;   // index into bases_
+        std::uint8_t  rarity  = 0;
+        std::uint8_t  kind    = 0;
+        std::array<AffixId, AffixList::kCapacity> affixes{};   // ascending, unused = kNoAffix
+        bool operator==(const Key& o) const;
+    };
+    struct Entry {
+        Key           key;
+        std::uint64_t count = 0;   // 0 = empty
+    };
+
+    std::uint16_t baseOf(std::string_view name);
+    void          addCombo(const Key& k, std::uint64_t n);
+    Combo         comboOf(const Entry& e) const;
+
+    std::size_t maxCombos_;
+    std::size_t used_ = 0;
+    std::vector<Entry> table_;   // open addressing, power of two >= 2 * maxCombos
+
+    std::vector<std::string>   bases_;
+    std::vector<std::uint64_t> baseHash_;
+
+    std::uint64_t drops_ = 0, kills_ = 0, otherDrops_ = 0;
+    std::array<std::uint64_t, kRarities> byRarity_{};
+    std::array<std::uint64_t, 2> byKind_{};
+    core::QuantileSketch dealt_, taken_, weaponDPR_;
+};
+
+} // namespace game
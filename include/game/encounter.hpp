@@ -1,6 +1,7 @@
 #pragma once
 #include <vector>
 #include "game/actor.hpp"
+#include "game/combat_event.hpp"
 #include "game/loot_tables.hpp"
 #include "game/inventory.hpp"
 #include "core/rng.hpp"
@@ -13,6 +14,7 @@ struct Encounter {
     LootTables loots;
     Inventory& inventory;     // NEW
     core::RNG& rng;
+    CombatEventRing* events = nullptr;  // null: print each round to std::cout
 
     void run();
 };
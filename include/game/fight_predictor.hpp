@@ -0,0 +1,34 @@
+#pragma once
+#include <vector>
+#include "game/actor.hpp"
+#include "game/combat_math.hpp"
+
+namespace game {
+
+// Exact outcome distribution of one fight under the simulate() rules with
+// auto-equip off: the player swings at the first living enemy, surplus
+// swings are lost on a kill, then every living enemy swings back.
+struct FightPrediction {
+    double pWin       = 0.0;
+    double pLoss      = 0.0;
+    double pTimeout   = 0.0;    // still undecided after maxRounds
+    double pTruncated = 0.0;    // undecided mass dropped below the cutoff
+
+    std::vector<double> roundsToWin;             // [r]  = P(win in round r)
+    std::vector<double> hpOnWin;                 // [hp] = P(win with hp left)
+    std::vector<std::vector<double>> killRound;  // [enemy][r] = P(enemy dies in round r)
+
+    double meanRoundsToWin() const;   // conditional on winning
+    double meanHpOnWin() const;
+};
+
+// dist[d] = P(one swing deals exactly d damage after flat armor), following
+// rollDamage() and applyArmor() including rounding and the crit roll.
+std::vector<double> damageDistribution(const SwingProfile& p, int armor);
+
+// Dynamic program over (current target, target hp, player hp), one round at
+// a time. Stops early once less than `cutoff` probability is undecided.
+FightPrediction predictFight(const Actor& player, const std::vector<Actor>& enemies,
+                             int maxRounds = 200, double cutoff = 1e-12);
+
+} // namespace game
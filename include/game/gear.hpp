@@ -1,6 +1,5 @@
 #pragma once
 #include <string>
-#include <vector>
 #include <sstream>
 #include "game/rarity.hpp"
 #include "game/affix.hpp"
@@ -13,16 +12,16 @@ struct Gear {
     Slot        slot;
     Rarity      rarity = Rarity::Common;
     int         armorBonus = 0;       // flat armor from this piece
-    std::vector<Affix> affixes;       // reuse same affix math as weapons
+    AffixList   affixes;              // reuse same affix math as weapons
 
     double pctDamage() const {
-        double p = 0.0; for (auto& a: affixes) p += a.pctDamage; return p;
+        return affixes.totals().pctDamage;
     }
     double critChance() const {
-        double c = 0.0; for (auto& a: affixes) c += a.critChance; return c;
+        return affixes.totals().critChance;
     }
     double attackSpeed() const {
-        double s = 0.0; for (auto& a: affixes) s += a.attackSpeed; return s;
+        return affixes.totals().attackSpeed;
     }
 
     std::string label() const {
@@ -32,7 +31,7 @@ struct Gear {
         if (!affixes.empty()) {
             os << " (";
             for (size_t i=0;i<affixes.size();++i) {
-                os << affixes[i].name;
+                os << affixDef(affixes[i]).name;
                 if (i+1<affixes.size()) os << ", ";
             }
             os << ")";
@@ -1,26 +1,47 @@
 #pragma once
+#include <array>
 #include <vector>
 #include <cstddef>
+#include <cstdint>
+#include <memory_resource>
 #include "game/item.hpp"
+#include "game/rarity.hpp"
 #include "game/slots.hpp"
 #include "game/combat_math.hpp"
+#include "game/weapon_columns.hpp"
 
 namespace game {
 
+// Generational reference to a stored item. Indices shift when items are
+// removed; a handle keeps naming the same item until that item is removed,
+// and never resolves to a later item that reuses its slot.
+struct ItemHandle {
+    std::uint32_t slot = 0xFFFFFFFFu;
+    std::uint32_t gen  = 0;
+    bool operator==(const ItemHandle& o) const { return slot == o.slot && gen == o.gen; }
+    bool operator!=(const ItemHandle& o) const { return !(*this == o); }
+};
+
 class Inventory {
 public:
     static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    // Items, their names and the DPR columns all come from `a`'s resource.
+    Inventory() = default;
+    explicit Inventory(const allocator_type& a)
+        : weapons_(a), gear_(a), weaponSlot_(a), gearSlot_(a), slots_(a), freeSlots_(a), weaponCols_(a) {}
 
     // Storage / add
     std::size_t addWeapon(Item w); // requires kind==Weapon
     std::size_t addGear(Item g);   // requires kind==Gear
 
     // Equip (weapons)
-    bool equip(std::size_t idx);            // main-hand
-    bool equipOffhand(std::size_t idx);     // off-hand weapon (disables shield)
+    bool equip(std::size_t idx);            // main-hand; takes it out of the off-hand if it was there
+    bool equipOffhand(std::size_t idx);     // off-hand weapon (disables shield); false for the main hand's
 
     // Equip (gear)
-    bool equipGear(std::size_t gearIdx);    // slot-aware; rings fill Ring1 then Ring2
+    bool equipGear(std::size_t gearIdx);    // slot-aware; rings fill Ring1 then Ring2, once each
 
     // Queries
     const Item* equipped() const;               // main-hand weapon
@@ -28,29 +49,94 @@ public:
     const Item* equipped(Slot slot) const;      // specific gear slot
 
     // Helpers
-    game::GearBonuses bonuses() const;
+    // Summed gear bonuses, kept up to date as slots change.
+    game::GearBonuses bonuses() const { if (bonusesDirty_) refreshBonuses(); return bonuses_; }
     bool equipBest(); // best-by-DPR considering gear bonuses
+    std::vector<std::size_t> topWeapons(std::size_t k) const; // weapon indices by DPR, best first
+
+    // Handles: O(1) to take, resolve and remove.
+    ItemHandle  weaponHandle(std::size_t i) const;    // i < weaponsCount()
+    ItemHandle  gearHandle(std::size_t i) const;      // i < gearCount()
+    const Item* find(ItemHandle h) const;             // nullptr once removed
+    std::size_t indexOf(ItemHandle h) const;          // weapon or gear index, npos once removed
+
+    // Removal swaps the last item of the same kind into the freed index;
+    // equipped indices follow the moved item, and removing an equipped item
+    // unequips it. Returns false for a stale handle.
+    bool remove(ItemHandle h);
+    // Bulk salvage of unequipped items; each returns how many were removed.
+    std::size_t salvageBelow(Rarity r);               // weapons and gear of a lower rarity than r
+    std::size_t salvageWeaponsBelow(double minDPR);   // DPR under the current bonuses()
 
     // Access
     std::size_t weaponsCount() const { return weapons_.size(); }
     std::size_t gearCount() const    { return gear_.size(); }
 
     const Item& weaponAt(std::size_t i) const { return weapons_.at(i); }
-    Item&       weaponAt(std::size_t i)       { return weapons_.at(i); }
-
     const Item& gearAt(std::size_t i)   const { return gear_.at(i); }
-    Item&       gearAt(std::size_t i)         { return gear_.at(i); }
 
+    // For editing an item in place. Named apart from the reads so a plain
+    // lookup can't mark the DPR columns or the gear bonuses stale.
+    Item& mutableWeaponAt(std::size_t i) { columnsDirty_ = true; return weapons_.at(i); }
+    Item& mutableGearAt(std::size_t i)   { bonusesDirty_ = true; return gear_.at(i); }
+
+    // Weapon indices for the hands, gear indices by Slot; gear[Offhand] is
+    // the shield and gear[Weapon] is unused.
     struct Equipped {
-        std::size_t mainHand     = npos;
-        std::size_t offHandWpn   = npos;
-        std::size_t offHandShield= npos;
-        std::size_t armor  = npos, helmet=npos, boots=npos, belt=npos, amulet=npos, ring1=npos, ring2=npos;
-    } eq_;
+        std::size_t mainHand   = npos;
+        std::size_t offHandWpn = npos;
+        std::array<std::size_t, kSlotCount> gear = noGear();
+
+        std::size_t& operator[](Slot s)       { return gear[slotIndex(s)]; }
+        std::size_t  operator[](Slot s) const { return gear[slotIndex(s)]; }
+
+        static std::array<std::size_t, kSlotCount> noGear() {
+            std::array<std::size_t, kSlotCount> a;
+            a.fill(npos);
+            return a;
+        }
+    };
+
+    const Equipped& loadout() const { return eq_; }
+    // Whole-loadout equip; false (no change) if any slot is invalid or one
+    // item is in two places (both hands, both rings).
+    bool applyLoadout(const Equipped& e);
+
+    // SoA mirror of weapons_ for DPR scans; rebuilt after mutableWeaponAt().
+    const WeaponColumns& weaponColumns() const;
 
 private:
-    std::vector<Item> weapons_; // kind==Weapon only
-    std::vector<Item> gear_;    // kind==Gear only
+    void setGear(Slot slot, std::size_t idx);
+    void sumBonuses() const;
+    void refreshBonuses() const;   // re-reads every equipped piece after mutableGearAt()
+    std::uint32_t newSlot(bool gear, std::size_t pos);
+    void removeWeaponAt(std::size_t i);
+    void removeGearAt(std::size_t i);
+    bool gearEquipped(std::size_t i) const;
+
+    // Handle slot: where its item lives now, and the generation a handle
+    // must carry to resolve. Freed slots are reused, so the table only grows
+    // to the most items held at once.
+    struct HandleSlot {
+        std::uint32_t pos  = kFreeSlot;
+        std::uint32_t gen  = 0;
+        bool          gear = false;
+    };
+    static constexpr std::uint32_t kFreeSlot = 0xFFFFFFFFu;
+
+    std::pmr::vector<Item> weapons_; // kind==Weapon only
+    std::pmr::vector<Item> gear_;    // kind==Gear only
+    std::pmr::vector<std::uint32_t> weaponSlot_, gearSlot_;   // index -> handle slot
+    std::pmr::vector<HandleSlot>    slots_;
+    std::pmr::vector<std::uint32_t> freeSlots_;
+    Equipped eq_;
+    mutable WeaponColumns weaponCols_;
+    mutable bool columnsDirty_ = false;
+
+    // Per-slot contributions of the equipped gear and their total.
+    mutable std::array<GearBonuses, kSlotCount> slotBonus_{};
+    mutable GearBonuses bonuses_{};
+    mutable bool bonusesDirty_ = false;
 };
 
 } // namespace game
\ No newline at end of file
@@ -1,7 +1,8 @@
 #pragma once
 #include <string>
-#include <vector>
 #include <algorithm>
+#include <cstddef>
+#include <memory_resource>
 #include <sstream>
 #include "game/rarity.hpp"
 #include "game/affix.hpp"
@@ -12,8 +13,12 @@ namespace game {
 enum class ItemKind { Weapon, Gear };
 enum class ArmorType { None, Light, Medium, Heavy };
 
+// Allocator-aware: placed in a pmr container, or built with an allocator,
+// the name draws from that memory resource (e.g. a per-batch arena).
 struct Item {
-    std::string name;
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    std::pmr::string name;
     Rarity      rarity = Rarity::Common;
     ItemKind    kind   = ItemKind::Gear;
     Slot        slot   = Slot::Armor;
@@ -27,27 +32,32 @@ struct Item {
     int       armorBonus = 0;
     ArmorType armorType  = ArmorType::None;
 
-    // Shared modifiers
-    std::vector<Affix> affixes;
+    // Shared modifiers (carries precomputed totals, see AffixList)
+    AffixList affixes;
+
+    Item() = default;
+    explicit Item(const allocator_type& a) : name(a) {}
+    Item(const Item&) = default;
+    Item(Item&&) = default;
+    Item(const Item& o, const allocator_type& a) : name(a) { *this = o; }
+    Item(Item&& o, const allocator_type& a) : name(a) { *this = std::move(o); }
+    Item& operator=(const Item&) = default;   // names keep their own resource
+    Item& operator=(Item&&) = default;
 
     bool isWeapon() const { return kind == ItemKind::Weapon; }
     bool isShield() const { return kind == ItemKind::Gear && slot == Slot::Offhand && armorBonus > 0; }
 
     int minDmg() const {
         if (!isWeapon()) return 0;
-        int m = baseMin;
-        for (auto& a : affixes) m += a.flatMin;
-        return std::max(1, m);
+        return std::max(1, baseMin + affixes.totals().flatMin);
     }
     int maxDmg() const {
         if (!isWeapon()) return 0;
-        int M = baseMax;
-        for (auto& a : affixes) M += a.flatMax;
-        return std::max(minDmg(), M);
+        return std::max(minDmg(), baseMax + affixes.totals().flatMax);
     }
-    double pctDamage() const { double p=0; for (auto& a:affixes) p += a.pctDamage; return p; }
-    double critChance() const { double c=0; for (auto& a:affixes) c += a.critChance; return std::clamp(c, 0.0, 0.95); }
-    double attackSpeed() const { double s=0; for (auto& a:affixes) s += a.attackSpeed; return s; }
+    double pctDamage() const   { return affixes.totals().pctDamage; }
+    double critChance() const  { return std::clamp(affixes.totals().critChance, 0.0, 0.95); }
+    double attackSpeed() const { return affixes.totals().attackSpeed; }
     double critMult() const { return 1.5; }
 
     std::string label() const {
@@ -61,7 +71,7 @@ struct Item {
         if (!affixes.empty()) {
             os << " (";
             for (size_t i=0;i<affixes.size();++i) {
-                os << affixes[i].name;
+                os << affixDef(affixes[i]).name;
                 if (i+1<affixes.size()) os << ", ";
             }
             os << ")";
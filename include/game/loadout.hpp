@@ -0,0 +1,35 @@
+#pragma once
+#include "game/inventory.hpp"
+#include "game/combat_math.hpp"
+
+namespace game {
+
+// Linear mix of the two things a loadout buys. Both weights must be >= 0:
+// the search relies on the score never dropping when a bonus grows.
+struct LoadoutObjective {
+    double dprWeight   = 1.0;
+    double armorWeight = 0.0;   // score per point of gear armor
+};
+
+struct LoadoutResult {
+    Inventory::Equipped eq;     // ready for Inventory::applyLoadout
+    GearBonuses bonuses;        // summed gear bonuses of eq
+    double dpr   = 0.0;         // main-hand expectedDPR + one off-hand swing
+    double score = 0.0;
+};
+
+// Best loadout over every slot in Inventory::Equipped: main hand, off-hand
+// weapon vs shield (none with a two-handed main hand), the five single gear
+// slots and the Ring1/Ring2 pair. Off-hand weapons count one swing per round,
+// as the Win32 round does.
+//
+// Candidates are first reduced to per-slot Pareto fronts over their
+// (armor, pct, crit, attack speed) contributions, ignoring stats the
+// objective gives no weight. The slots then split into two halves
+// (armor/helmet/boots and rings/belt/amulet) whose summed fronts are joined
+// once into a front of whole gear sets. Main hand and off-hand pairs scan
+// that front best bound first, stopping as soon as no remaining pair can
+// beat the incumbent.
+LoadoutResult optimizeLoadout(const Inventory& inv, const LoadoutObjective& obj = {});
+
+} // namespace game
@@ -1,16 +1,21 @@
 #pragma once
 #include <vector>
+#include <cstddef>
+#include <memory>
 #include <string>
 #include "core/weighted_table.hpp"
 #include "game/rarity.hpp"
 #include "game/weapon_base.hpp"
 #include "game/affix.hpp"
+#include "game/affix_pool.hpp"
 #include "game/item.hpp"
 #include "core/rng.hpp"
 #include "game/slots.hpp"
 
 namespace game {
 
+class ContentPack;
+
 struct GearBase {
     Slot        slot;
     std::string name;
@@ -23,14 +28,38 @@ struct LootTables {
     core::WeightedTable<Rarity>     rarity;
     core::WeightedTable<WeaponBase> bases;
     core::WeightedTable<GearBase>   gearBases;
-    std::vector<Affix> prefixes;
-    std::vector<Affix> suffixes;
+    AffixPool prefixes;   // level-gated tiers of interned affixes
+    AffixPool suffixes;
+    // Set by openContentPack(): the four tables above are left empty and
+    // rolls draw from the mapped pack instead.
+    std::shared_ptr<const ContentPack> pack;
+    // Set by makeDefaultLoot(): the four tables are the constexpr ones in
+    // game/default_loot.hpp. build() clears it once any of the tables above
+    // has entries, copying the defaults in ahead of them.
+    bool builtin = false;
 
     Item rollWeapon(core::RNG& rng, int level) const;  // kind==Weapon
     Item rollGear(core::RNG& rng, int level) const;    // kind==Gear
     bool rollIsGear(core::RNG& rng) const;             // uses dropType
+    void build();                                      // compile alias and affix tables after edits
+
+    // Fill-in-place forms: overwrite every field of `out`, reusing the
+    // storage it already owns. Same draws as rollWeapon/rollGear.
+    void rollWeaponInto(core::RNG& rng, int level, Item& out) const;
+    void rollGearInto(core::RNG& rng, int level, Item& out) const;
+
+    // Batch forms over a caller-owned buffer of `count` Items. Results match
+    // the equivalent sequence of single calls for the same RNG state, so a
+    // buffer reused across batches stops allocating once it has warmed up.
+    void rollWeapons(core::RNG& rng, int level, Item* out, std::size_t count) const;
+    void rollGears(core::RNG& rng, int level, Item* out, std::size_t count) const;
+    void rollDrops(core::RNG& rng, int level, Item* out, std::size_t count) const; // rollIsGear decides each
 };
 
+// Built-in content; only the affix pools are built here.
 LootTables makeDefaultLoot();
+// The same content as ordinary tables that can be edited and rebuilt; rolls
+// match makeDefaultLoot() until they are.
+LootTables makeEditableDefaultLoot();
 
 } // namespace game
\ No newline at end of file
@@ -16,4 +16,12 @@ inline std::string rarityName(Rarity r) {
     return "Common";
 }
 
+// Inverse of rarityName; false for anything else.
+inline bool parseRarity(const std::string& s, Rarity& out) {
+    for (int i = 0; i <= static_cast<int>(Rarity::Legendary); ++i) {
+        if (s == rarityName(static_cast<Rarity>(i))) { out = static_cast<Rarity>(i); return true; }
+    }
+    return false;
+}
+
 } // namespace game
\ No newline at end of file
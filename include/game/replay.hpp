@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace game {
+
+// Player inputs of a Session, in the order main_cli.cpp issues them.
+// Salvage and AutoSalvage were added in version 2.
+enum class ReplayOp : std::uint8_t { Target, Next, Equip, Best, ToggleAuto, Reset, Salvage, AutoSalvage };
+
+struct ReplayCommand {
+    ReplayOp     op  = ReplayOp::Next;
+    std::int32_t arg = 0;   // index for Target / Equip; Rarity for Salvage / AutoSalvage;
+                            // for Next, 1 if a round was played
+};
+
+// Everything needed to re-run a session: the seed, the RNG sequence it was
+// recorded with and the command stream. Each Next that played a round also
+// stores the state checksum after that round.
+struct Replay {
+    static constexpr std::uint16_t kVersion = 2;   // version 1 files still read
+
+    std::uint64_t seed     = 0;
+    std::uint32_t engineId = 0;   // core::kRngEngineId at record time
+    std::vector<ReplayCommand> commands;
+    std::vector<std::uint32_t> roundChecksums;
+};
+
+// Binary layout (little endian): "OBRP", u16 version, u16 engine id, u64 seed,
+// u32 command count, then per command one op byte, a zigzag LEB128 argument
+// for Target/Equip/Salvage/AutoSalvage, and for a Next that played a round the op byte has 0x80
+// set and is followed by that round's u32 checksum.
+bool writeReplay(std::ostream& os, const Replay& r);
+bool readReplay(std::istream& is, Replay& r);   // false on bad magic/version or truncation
+
+bool saveReplay(const std::string& path, const Replay& r);
+bool loadReplay(const std::string& path, Replay& r);
+
+struct ReplayCheck {
+    bool          ok = false;
+    std::size_t   commandsRun = 0;
+    std::uint32_t rounds = 0;
+    long          firstBadRound = -1;   // 1-based index into roundChecksums, -1 if none
+    std::string   error;                // set when ok is false
+};
+
+// Re-executes the commands on a fresh Session without any event output and
+// compares every round checksum against the recording.
+ReplayCheck verifyReplay(const Replay& r);
+
+} // namespace game
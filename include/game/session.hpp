@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "core/rng.hpp"
+#include "game/actor.hpp"
+#include "game/combat_event.hpp"
+#include "game/inventory.hpp"
+#include "game/loot_tables.hpp"
+#include "game/replay.hpp"
+
+namespace game {
+
+// The console game's rules without any I/O: starter inventory, the fixed
+// three-enemy pack, targeting, rounds, drops, auto-equip and salvage. Every random
+// draw comes from the session's RNG, so a seed plus the command stream
+// reproduces a session exactly.
+class Session {
+public:
+    static constexpr std::uint64_t kDefaultSeed = 1337;
+
+    // `events` (optional) receives combat events; nothing is formatted here.
+    explicit Session(std::uint64_t seed = kDefaultSeed, CombatEventRing* events = nullptr);
+
+    // Commands. Each returns false and changes nothing when it does not apply.
+    bool target(int idx);
+    bool next();            // one round: player, then enemies
+    bool equip(int idx);    // weapon index
+    bool equipBest();
+    void toggleAuto();
+    void reset();           // fresh pack and full hp, inventory kept (less auto-salvage)
+    // Removes unequipped items of a lower rarity than `below`; false if none.
+    bool salvage(Rarity below);
+    // Salvage below `below` on every reset() from now on; Common turns it off.
+    // It waits for reset so drop events of the current pack stay valid.
+    void setAutoSalvage(Rarity below);
+    bool apply(const ReplayCommand& c);
+
+    const Actor&              player() const    { return player_; }
+    const std::vector<Actor>& enemies() const   { return enemies_; }
+    const Inventory&          inventory() const { return inv_; }
+    const CombatRoster&       roster() const    { return roster_; }
+    int           selectedEnemy() const { return selected_; }
+    bool          autoEquip() const     { return autoEquip_; }
+    Rarity        autoSalvage() const   { return autoSalvage_; }
+    std::uint32_t round() const         { return round_; }
+    bool          anyEnemyAlive() const;
+
+    // FNV-1a over hp, inventory, selection and the RNG position.
+    std::uint32_t checksum() const;
+
+    // Records seed, engine and every command from now on into `out`. Call it
+    // before the first command; playback always starts from a fresh session.
+    void record(Replay* out);
+
+private:
+    void emit(const CombatEvent& e) { if (events_) events_->push(e); }
+    void playerTurn();
+    void enemiesTurn();
+
+    std::uint64_t seed_;
+    core::RNG rng_;
+    LootTables loot_;
+    Inventory inv_;
+    Actor player_;
+    std::vector<Actor> enemies_;
+    CombatRoster roster_;
+    int  selected_  = 0;
+    bool autoEquip_ = true;
+    Rarity autoSalvage_ = Rarity::Common;
+    std::uint32_t round_ = 0;
+    CombatEventRing* events_ = nullptr;
+    Replay* recorder_ = nullptr;
+};
+
+} // namespace game
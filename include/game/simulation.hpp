@@ -0,0 +1,69 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "game/actor.hpp"
+#include "game/drop_stats.hpp"
+#include "game/loot_tables.hpp"
+#include "game/rarity.hpp"
+#include "core/rng.hpp"
+
+namespace game {
+
+// Headless counterpart of Encounter::run(): same turn order and drop rules,
+// no I/O, no inventory growth. Every encounter starts from the config state.
+struct SimConfig {
+    Actor player;
+    std::vector<Actor> enemies;
+    int  level     = 1;     // passed to LootTables::rollWeapon
+    int  maxRounds = 200;   // fights still undecided after this count as timeouts
+    bool autoEquip = true;  // swap to a dropped weapon if its DPR is higher
+};
+
+struct SimStats {
+    static constexpr std::size_t kRarities = 5;
+
+    std::uint64_t encounters = 0;
+    std::uint64_t wins       = 0;
+    std::uint64_t losses     = 0;
+    std::uint64_t timeouts   = 0;
+    std::uint64_t rounds     = 0;   // total rounds across all encounters
+    std::uint64_t kills      = 0;
+    std::uint64_t autoEquips = 0;
+
+    std::vector<std::uint64_t> roundsToWin;   // [r] = wins that took r rounds
+    std::vector<std::uint64_t> hpOnWin;       // [hp] = wins that ended with hp left
+    std::array<std::uint64_t, kRarities> dropsByRarity{};
+
+    double winRate() const      { return encounters ? double(wins) / double(encounters) : 0.0; }
+    double meanRoundsToWin() const;
+    double meanHpOnWin() const;
+
+    // Adds another run's counts. All fields are integer sums, so merging is
+    // exact and order-independent.
+    void merge(const SimStats& o);
+};
+
+// `drops` (optional) also receives every drop and kill, and the damage of
+// each swing after armor. It draws nothing, so results are the same with it.
+SimStats simulate(const SimConfig& cfg, const LootTables& loot, core::RNG& rng, std::uint64_t encounters,
+                  DropStats* drops = nullptr);
+
+// Encounters per shard in simulateParallel(). Part of the result contract:
+// changing it changes which RNG stream each encounter draws from.
+constexpr std::uint64_t kSimShardSize = 16384;
+
+// Splits the batch into fixed-size shards, runs shard k with its own stream
+// core::RNG::forStream(seed, k) on `threads` workers (0 = one per core) and
+// merges per-worker stats at the end. Aggregates are identical for any
+// thread count; so are `drops`' unless its combination table fills up.
+SimStats simulateParallel(const SimConfig& cfg, const LootTables& loot, std::uint64_t seed,
+                          std::uint64_t encounters, unsigned threads = 0, DropStats* drops = nullptr);
+
+// Drop-only study: rolls `drops` drops (weapon or gear by rollIsGear) at
+// `level` into `out`, sharded and seeded like simulateParallel(). Every kill
+// drops one item in the game modes, so each drop also counts as a kill.
+void studyDrops(const LootTables& loot, int level, std::uint64_t seed, std::uint64_t drops,
+                DropStats& out, unsigned threads = 0);
+
+} // namespace game
@@ -1,8 +1,12 @@
 #pragma once
+#include <cstddef>
 
 namespace game {
 
 enum class Slot { Weapon, Offhand, Armor, Helmet, Boots, Belt, Amulet, Ring1, Ring2 };
+inline constexpr std::size_t kSlotCount = 9;   // for arrays indexed by Slot
+
+inline constexpr std::size_t slotIndex(Slot s) { return static_cast<std::size_t>(s); }
 
 inline const char* slotName(Slot s) {
     switch (s) {
@@ -0,0 +1,89 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "game/loot_tables.hpp"
+#include "game/simulation.hpp"
+
+namespace game {
+
+// What a tuning parameter changes in the built-in loot. `what` narrows it:
+//   RarityWeight  weight of the rarity named `what` (must stay > 0)
+//   WeaponDamage  multiplier on baseMin/baseMax of the weapon base named
+//                 `what`, or of every base when empty
+//   AffixScale    multiplier on every stat of the affix tiers named `what`
+//                 (all tiers of that name), or of every tier when empty
+enum class TuneKnob { RarityWeight, WeaponDamage, AffixScale };
+
+// `steps` evenly spaced values from lo to hi inclusive (just lo if 1).
+struct TuneParam {
+    TuneKnob    knob  = TuneKnob::RarityWeight;
+    std::string what;
+    double      lo    = 1.0;
+    double      hi    = 1.0;
+    int         steps = 5;
+
+    double value(int step) const;
+};
+
+// Loss of a configuration: |win rate - winRate|, plus roundsWeight times the
+// relative miss on mean rounds-to-win when roundsToWin > 0. Lower is better.
+struct TuneTarget {
+    double winRate      = 0.5;
+    double roundsToWin  = 0.0;
+    double roundsWeight = 1.0;
+
+    double loss(const SimStats& s) const;
+};
+
+struct TuneOptions {
+    std::uint64_t minEncounters = 4096;     // first-rung budget per configuration
+    std::uint64_t maxEncounters = 131072;   // budget once a configuration survives every cut
+    unsigned      eta           = 2;        // keep 1/eta per rung, grow the budget eta times
+    std::size_t   maxConfigs    = 256;      // larger grids are sampled
+    std::uint64_t seed          = 1337;
+    unsigned      threads       = 0;        // 0 = one per core
+};
+
+struct TuneConfig {
+    std::vector<double> values;   // one per TuneParam
+    SimStats            stats;    // every encounter it was given
+    double              loss = 0.0;
+    int                 rungs = 0;   // rungs it took part in
+};
+
+struct TuneResult {
+    std::vector<TuneConfig> configs;   // best first: by rungs survived, then loss
+    std::uint64_t encounters = 0;      // simulated in total
+    int           rungs      = 0;
+};
+
+// Builds configurations of the built-in loot on a shared edited copy:
+// tables no parameter touches are copied as built, and only the ones a
+// parameter changes are refilled and rebuilt. Affix scales ride on the pool
+// tiers (AffixTier::scale), so no affix definitions are registered and any
+// number of configurations can be made.
+class TunedLoot {
+public:
+    TunedLoot();
+    // False if a parameter names an unknown rarity, base or affix, or has an
+    // unusable range.
+    bool valid(const std::vector<TuneParam>& params) const;
+    LootTables make(const std::vector<TuneParam>& params, const std::vector<double>& values) const;
+
+private:
+    LootTables base_;
+};
+
+// Successive halving over the parameter grid (or maxConfigs samples of it).
+// Every configuration starts with minEncounters; after each rung the best
+// 1/eta by loss go on with eta times the budget, until one is left or the
+// budget reaches maxEncounters. Each configuration's encounter k comes from
+// the same RNG stream, so configurations are compared on common random
+// numbers, and a configuration's totals at budget B are those of one run of
+// B encounters. Results are identical for any thread count.
+TuneResult tune(const SimConfig& cfg, const std::vector<TuneParam>& params, const TuneTarget& target,
+                const TuneOptions& opt = {});
+
+} // namespace game
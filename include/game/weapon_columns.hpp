@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+#include "game/item.hpp"
+#include "game/combat_math.hpp"
+
+namespace game {
+
+// Structure-of-arrays copy of the stats expectedDPR() reads, one row per
+// weapon. Names and affix ids stay on the Items; scans over these columns
+// touch ~40 bytes per weapon and vectorise.
+struct WeaponColumns {
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    std::pmr::vector<int>          minDmg;
+    std::pmr::vector<int>          maxDmg;
+    std::pmr::vector<double>       pct;
+    std::pmr::vector<double>       crit;      // already clamped like Item::critChance()
+    std::pmr::vector<double>       critMult;
+    std::pmr::vector<double>       as;
+    std::pmr::vector<std::uint8_t> twoHanded;
+
+    WeaponColumns() = default;
+    explicit WeaponColumns(const allocator_type& a)
+        : minDmg(a), maxDmg(a), pct(a), crit(a), critMult(a), as(a), twoHanded(a) {}
+
+    std::size_t size() const { return minDmg.size(); }
+    void clear();
+    void push_back(const Item& w);
+    void swapRemove(std::size_t i);   // last row moves into row i
+    void assign(const Item* weapons, std::size_t n);
+
+    // out[i] = expectedDPR(weapon i, b.pctDamage, b.critChance, b.attackSpeed),
+    // bit-identical to the scalar function.
+    void dpr(const GearBonuses& b, double* out) const;
+
+    // Highest-DPR row (first one on ties), npos when empty.
+    std::size_t best(const GearBonuses& b, bool oneHandedOnly = false) const;
+    // Up to k rows by descending DPR, ties broken by lower index.
+    std::vector<std::size_t> topK(const GearBonuses& b, std::size_t k, bool oneHandedOnly = false) const;
+};
+
+} // namespace game
@@ -4,10 +4,11 @@
 
 namespace game {
 
-int Actor::attack(Actor& target, core::RNG& rng, double extraPct, double extraCrit) const {
-    int dmg = rollDamageWithBonuses(weapon, rng, extraPct, extraCrit);
-    dmg = std::max(0, dmg - target.armor);
-    return dmg;
+int Actor::attack(Actor& target, core::RNG& rng, double extraPct, double extraCrit, bool* crit) const {
+    bool c;
+    int dmg = rollDamage(makeSwingProfile(weapon, extraPct, extraCrit), rng, c);
+    if (crit) *crit = c;
+    return applyArmor(dmg, target.armor);
 }
 
 } // namespace game
\ No newline at end of file
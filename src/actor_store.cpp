@@ -0,0 +1,102 @@
+#include "game/actor_store.hpp"
+#include "game/combat_math.hpp"
+#include "game/damage_batch.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace game {
+
+const std::string& ActorView::name() const { return s_->names_[id_]; }
+const Item&        ActorView::weapon() const { return s_->weapons_[id_]; }
+int ActorView::hp() const    { return s_->hp(id_); }
+int ActorView::maxHP() const { return s_->maxHP_[id_]; }
+int ActorView::armor() const { return s_->baseArmor_[id_]; }
+
+std::uint32_t ActorStore::add(const Actor& a) {
+    const auto id = static_cast<std::uint32_t>(names_.size());
+    names_.emplace_back(a.name);
+    weapons_.push_back(a.weapon);
+    maxHP_.push_back(a.maxHP);
+    baseArmor_.push_back(a.armor);
+    finalHp_.push_back(a.hp);
+    if (a.hp <= 0) { slot_.push_back(kDead); return id; }
+
+    const SwingProfile p = makeSwingProfile(a.weapon);
+    slot_.push_back(static_cast<std::uint32_t>(dense_.size()));
+    dense_.push_back(id);
+    hp_.push_back(a.hp);
+    armor_.push_back(a.armor);
+    hits_.push_back(swingsPerRound(a.weapon));
+    minDmg_.push_back(p.minDmg);
+    span_.push_back(p.maxDmg - p.minDmg + 1);
+    scale_.push_back(p.scale);
+    critC_.push_back(p.critC);
+    critMult_.push_back(p.critMult);
+    return id;
+}
+
+int ActorStore::hp(std::uint32_t id) const {
+    return slot_[id] == kDead ? finalHp_[id] : hp_[slot_[id]];
+}
+
+Actor ActorStore::toActor(std::uint32_t id) const {
+    return Actor{names_[id], maxHP_[id], hp(id), baseArmor_[id], weapons_[id]};
+}
+
+int ActorStore::damage(std::uint32_t id, int dmg) {
+    const std::uint32_t s = slot_[id];
+    if (s == kDead) return finalHp_[id];
+    const int left = hp_[s] -= dmg;
+    if (left <= 0) remove(id);
+    return left;
+}
+
+void ActorStore::remove(std::uint32_t id) {
+    const std::uint32_t s = slot_[id];
+    const std::size_t last = dense_.size() - 1;
+    finalHp_[id] = hp_[s];
+
+    auto moveLast = [&](auto& col) { col[s] = col[last]; col.pop_back(); };
+    moveLast(dense_);
+    moveLast(hp_);
+    moveLast(armor_);
+    moveLast(hits_);
+    moveLast(minDmg_);
+    moveLast(span_);
+    moveLast(scale_);
+    moveLast(critC_);
+    moveLast(critMult_);
+    if (s != last) slot_[dense_[s]] = s;
+    slot_[id] = kDead;
+}
+
+std::int64_t ActorStore::attackPhase(core::RNG& rng, int targetArmor) {
+    const std::size_t n = dense_.size();
+    if (n == 0) return 0;
+    const int maxHits = *std::max_element(hits_.begin(), hits_.end());
+    draws_.resize(2 * n);
+    rolls_.resize(2 * n);
+
+    const int*    __restrict hi = hits_.data();
+    const int*    __restrict mn = minDmg_.data();
+    const int*    __restrict sp = span_.data();
+    const double* __restrict u  = draws_.data();
+    int*          __restrict rb = rolls_.data();       // base rolls
+    int*          __restrict rd = rolls_.data() + n;   // damage
+    const SwingColumns cols{scale_.data(), critC_.data(), critMult_.data()};
+
+    std::int64_t total = 0;
+    for (int h = 0; h < maxHits; ++h) {
+        rng.fillUnit(draws_.data(), 2 * n);   // u[i] base roll, u[n + i] crit roll
+        for (std::size_t i = 0; i < n; ++i) rb[i] = mn[i] + static_cast<int>(u[i] * sp[i]);
+        damageBatch(cols, rb, u + n, rd, n);
+        // applyArmor() with the branch spelled as a select.
+        for (std::size_t i = 0; i < n; ++i) {
+            const int hit = std::max(0, rd[i] - targetArmor);
+            total += h < hi[i] ? hit : 0;
+        }
+    }
+    return total;
+}
+
+} // namespace game
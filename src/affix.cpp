@@ -0,0 +1,24 @@
+#include "game/affix.hpp"
+
+namespace game {
+
+static bool sameAffix(const Affix& a, const Affix& b) {
+    return a.name == b.name && a.flatMin == b.flatMin && a.flatMax == b.flatMax &&
+           a.pctDamage == b.pctDamage && a.critChance == b.critChance && a.attackSpeed == b.attackSpeed;
+}
+
+AffixId AffixRegistry::intern(const Affix& a) {
+    for (std::size_t i = 0; i < defs_.size(); ++i) {
+        if (sameAffix(defs_[i], a)) return static_cast<AffixId>(i);
+    }
+    if (defs_.size() >= kMaxAffixes) return kNoAffix;
+    defs_.push_back(a);
+    return static_cast<AffixId>(defs_.size() - 1);
+}
+
+AffixRegistry& AffixRegistry::global() {
+    static AffixRegistry reg;
+    return reg;
+}
+
+} // namespace game
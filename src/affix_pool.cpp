@@ -0,0 +1,71 @@
+#include "game/affix_pool.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace game {
+
+static int clampLevel(int level) { return std::clamp(level, 1, AffixPool::kMaxLevel); }
+
+void AffixPool::add(AffixId affix, double weight, int minLevel, int maxLevel, double scale) {
+    if (!std::isfinite(weight) || weight <= 0 || affix == kNoAffix) return;
+    std::uint16_t group = nextGroup_;
+    const std::string& name = affixDef(affix).name;
+    for (const auto& t : tiers_) {
+        if (affixDef(t.affix).name == name) { group = t.group; break; }
+    }
+    if (group == nextGroup_) ++nextGroup_;
+    tiers_.push_back(AffixTier{affix, weight, minLevel, maxLevel, group, scale});
+    bands_.clear();   // stale until build()
+}
+
+void AffixPool::build() {
+    bands_.clear();
+    if (tiers_.empty()) return;
+
+    // A band starts at level 1 and wherever a tier's eligibility changes.
+    std::vector<int> starts{1};
+    for (const auto& t : tiers_) {
+        if (t.minLevel > 1 && t.minLevel <= kMaxLevel) starts.push_back(t.minLevel);
+        if (t.maxLevel >= 1 && t.maxLevel < kMaxLevel) starts.push_back(t.maxLevel + 1);
+    }
+    std::sort(starts.begin(), starts.end());
+    starts.erase(std::unique(starts.begin(), starts.end()), starts.end());
+
+    std::vector<std::uint16_t> seen;
+    for (std::size_t b = 0; b < starts.size(); ++b) {
+        const int lo = starts[b];
+        const int hi = b + 1 < starts.size() ? starts[b + 1] - 1 : kMaxLevel;
+        Band band;
+        seen.clear();
+        for (std::size_t i = 0; i < tiers_.size(); ++i) {
+            const AffixTier& t = tiers_[i];
+            if (t.minLevel > lo || t.maxLevel < lo) continue;
+            band.table.add(static_cast<std::uint32_t>(i), t.weight);
+            if (std::find(seen.begin(), seen.end(), t.group) == seen.end()) seen.push_back(t.group);
+        }
+        band.table.build();
+        band.groups = static_cast<int>(seen.size());
+        for (int lvl = lo; lvl <= hi; ++lvl) bandOfLevel_[lvl] = static_cast<std::uint16_t>(bands_.size());
+        bands_.push_back(std::move(band));
+    }
+}
+
+void AffixPool::roll(core::RNG& rng, int level, int count, AffixList& out) const {
+    if (bands_.empty()) return;
+    const Band& band = bands_[bandOfLevel_[clampLevel(level)]];
+    count = std::min({count, band.groups, static_cast<int>(AffixList::kCapacity - out.size())});
+
+    // Redraw on a group already taken. Counts are capped by the groups
+    // available, so this ends; it takes few redraws unless a taken group
+    // holds most of the band's weight.
+    std::array<std::uint16_t, AffixList::kCapacity> taken;
+    int n = 0;
+    while (n < count) {
+        const AffixTier& t = tiers_[band.table.pick(rng)];
+        if (std::find(taken.begin(), taken.begin() + n, t.group) != taken.begin() + n) continue;
+        taken[n++] = t.group;
+        out.push_back(t.affix, t.scale);
+    }
+}
+
+} // namespace game
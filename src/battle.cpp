@@ -0,0 +1,101 @@
+#include "game/battle.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace game {
+
+Battle::Battle(const std::vector<Actor>& allies, const std::vector<Actor>& enemies) {
+    fighters_.reserve(allies.size() + enemies.size());
+    for (const auto& a : allies)  add(a, 0);
+    for (const auto& e : enemies) add(e, 1);
+}
+
+void Battle::add(const Actor& a, std::uint8_t side) {
+    Fighter f;
+    f.hp       = a.hp;
+    f.armor    = a.armor;
+    f.swing    = makeSwingProfile(a.weapon);
+    f.interval = 1.0 / expectedAPS(a.weapon);
+    f.side     = side;
+    const auto id = static_cast<std::uint32_t>(fighters_.size());
+    if (f.hp > 0) {
+        f.slot = static_cast<std::uint32_t>(alive_[side].size());
+        alive_[side].push_back(id);
+        heap_.push_back(Turn{f.interval, id});
+    }
+    fighters_.push_back(f);
+}
+
+void Battle::kill(std::uint32_t id) {
+    // Swap-remove from the side's living list; its queued turn is dropped
+    // when it comes up.
+    Fighter& f = fighters_[id];
+    auto& list = alive_[f.side];
+    const std::uint32_t last = list.back();
+    list[f.slot] = last;
+    fighters_[last].slot = f.slot;
+    list.pop_back();
+}
+
+BattleResult Battle::run(core::RNG& rng, double maxRounds, CombatEventRing* events) {
+    const std::greater<Turn> later;
+    std::make_heap(heap_.begin(), heap_.end(), later);
+    if (fighters_.size() >= kNoActor) events = nullptr;   // ids wouldn't fit the 16-bit fields
+
+    BattleResult res;
+    while (!alive_[0].empty() && !alive_[1].empty() && !heap_.empty()) {
+        const Turn turn = heap_.front();
+        if (turn.time > maxRounds) break;
+        std::pop_heap(heap_.begin(), heap_.end(), later);
+        heap_.pop_back();
+
+        Fighter& f = fighters_[turn.id];
+        if (f.hp <= 0) continue;   // died since this turn was queued
+
+        const auto& foes = alive_[f.side ^ 1];
+        if (f.target == kNone || fighters_[f.target].hp <= 0) {
+            f.target = foes[static_cast<std::size_t>(rng.below(foes.size()))];
+        }
+        Fighter& t = fighters_[f.target];
+        bool crit = false;
+        const int dmg = applyArmor(rollDamage(f.swing, rng, crit), t.armor);
+        t.hp -= dmg;
+        ++res.swings;
+        res.time = turn.time;
+
+        const auto round = static_cast<std::uint32_t>(std::ceil(turn.time));
+        if (events) {
+            events->push(CombatEvent{round, CombatEventKind::Hit, crit ? kEventCrit : std::uint8_t(0),
+                                     static_cast<std::uint16_t>(turn.id), static_cast<std::uint16_t>(f.target),
+                                     dmg, t.hp, kNoDrop});
+        }
+        if (t.hp <= 0) {
+            if (events) {
+                events->push(CombatEvent{round, CombatEventKind::Slain, 0, static_cast<std::uint16_t>(turn.id),
+                                         static_cast<std::uint16_t>(f.target), 0, 0, kNoDrop});
+            }
+            kill(f.target);
+        }
+
+        // Times are multiples of the interval, so long battles don't drift.
+        ++f.swings;
+        heap_.push_back(Turn{static_cast<double>(f.swings + 1) * f.interval, turn.id});
+        std::push_heap(heap_.begin(), heap_.end(), later);
+    }
+
+    res.alliesAlive  = alive_[0].size();
+    res.enemiesAlive = alive_[1].size();
+    res.outcome = res.enemiesAlive == 0 ? BattleOutcome::AlliesWin
+                : res.alliesAlive == 0  ? BattleOutcome::EnemiesWin
+                                        : BattleOutcome::Timeout;
+    if (events && res.outcome != BattleOutcome::Timeout) {
+        const bool won = res.outcome == BattleOutcome::AlliesWin;
+        events->push(CombatEvent{static_cast<std::uint32_t>(std::ceil(res.time)),
+                                 won ? CombatEventKind::Victory : CombatEventKind::Defeat, 0,
+                                 kPlayerActor, kNoActor, 0, fighters_.empty() ? 0 : fighters_[0].hp, kNoDrop});
+    }
+    return res;
+}
+
+} // namespace game
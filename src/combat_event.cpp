@@ -0,0 +1,83 @@
+#include "game/combat_event.hpp"
+#include "game/inventory.hpp"
+#include <algorithm>
+#include <ostream>
+#include <sstream>
+
+namespace game {
+
+CombatRoster CombatRoster::of(const Actor& player, const std::vector<Actor>& enemies) {
+    CombatRoster r;
+    r.names.reserve(enemies.size() + 1);
+    r.maxHP.reserve(enemies.size() + 1);
+    r.names.emplace_back(player.name);
+    r.maxHP.push_back(player.maxHP);
+    for (const auto& e : enemies) {
+        r.names.emplace_back(e.name);
+        r.maxHP.push_back(e.maxHP);
+    }
+    return r;
+}
+
+static const std::string& nameOf(const CombatRoster& r, std::uint16_t id) {
+    static const std::string unknown = "?";
+    return id < r.names.size() ? r.names[id] : unknown;
+}
+
+static int maxHpOf(const CombatRoster& r, std::uint16_t id) {
+    return id < r.maxHP.size() ? r.maxHP[id] : 0;
+}
+
+static void dropLabel(std::ostream& os, const CombatEvent& e, const Inventory* inv) {
+    const bool gear = (e.flags & kEventGear) != 0;
+    if (inv && e.dropId != kNoDrop) {
+        const std::size_t i = e.dropId;
+        if (gear && i < inv->gearCount())     { os << inv->gearAt(i).label();   return; }
+        if (!gear && i < inv->weaponsCount()) { os << inv->weaponAt(i).label(); return; }
+    }
+    os << (gear ? "gear #" : "weapon #") << e.dropId;
+}
+
+void formatEvent(std::ostream& os, const CombatEvent& e, const CombatRoster& roster, const Inventory* inv) {
+    const bool crit = (e.flags & kEventCrit) != 0;
+    switch (e.kind) {
+        case CombatEventKind::RoundStart:
+            os << "=== Round " << e.round << " ===";
+            break;
+        case CombatEventKind::Hit:
+            if (e.attacker == kPlayerActor) {
+                os << "You" << ((e.flags & kEventOffhand) ? " (OH)" : "") << (crit ? " crit " : " hit ")
+                   << nameOf(roster, e.target) << " for " << e.damage
+                   << " (" << std::max(0, e.hpAfter) << "/" << maxHpOf(roster, e.target) << ")";
+            } else {
+                os << nameOf(roster, e.attacker) << (crit ? " crits" : " hits") << " you for " << e.damage
+                   << " (You: " << std::max(0, e.hpAfter) << "/" << maxHpOf(roster, kPlayerActor) << ")";
+            }
+            break;
+        case CombatEventKind::Slain:
+            os << nameOf(roster, e.target) << " is slain!";
+            break;
+        case CombatEventKind::Drop:
+            os << "Loot dropped: ";
+            dropLabel(os, e, inv);
+            break;
+        case CombatEventKind::AutoEquip:
+            os << "Auto-equipped better weapon: ";
+            dropLabel(os, e, inv);
+            break;
+        case CombatEventKind::Victory:
+            os << "Victory! You survived with " << e.hpAfter << " HP.";
+            break;
+        case CombatEventKind::Defeat:
+            os << "Defeat. You died.";
+            break;
+    }
+}
+
+std::string formatEvent(const CombatEvent& e, const CombatRoster& roster, const Inventory* inv) {
+    std::ostringstream os;
+    formatEvent(os, e, roster, inv);
+    return os.str();
+}
+
+} // namespace game
@@ -0,0 +1,263 @@
+#include "game/content_pack.hpp"
+#include "game/loot_tables.hpp"
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace game {
+
+static_assert(std::is_trivially_copyable<PackHeader>::value && sizeof(PackHeader) == 224, "pack header layout");
+static_assert(sizeof(PackWeaponBase) == 16 && sizeof(PackGearBase) == 24 && sizeof(PackAffix) == 56,
+              "pack record layout");
+
+// ---------------------------------------------------------------------------
+// Mapping
+
+std::shared_ptr<const ContentPack> ContentPack::open(const std::string& path) {
+    std::shared_ptr<ContentPack> p(new ContentPack());
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return nullptr;
+    LARGE_INTEGER size;
+    HANDLE map = nullptr;
+    if (GetFileSizeEx(file, &size) && size.QuadPart >= static_cast<LONGLONG>(sizeof(PackHeader))) {
+        map = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    CloseHandle(file);   // the mapping keeps the file open
+    if (!map) return nullptr;
+    p->mapping_ = map;
+    p->base_ = static_cast<const unsigned char*>(MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0));
+    p->size_ = static_cast<std::size_t>(size.QuadPart);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+    struct stat st;
+    void* mem = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size >= static_cast<off_t>(sizeof(PackHeader))) {
+        mem = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);   // the mapping keeps the file open
+    if (mem == MAP_FAILED) return nullptr;
+    p->base_ = static_cast<const unsigned char*>(mem);
+    p->size_ = static_cast<std::size_t>(st.st_size);
+#endif
+    if (!p->base_ || !p->validate()) return nullptr;
+    return p;
+}
+
+ContentPack::~ContentPack() {
+#if defined(_WIN32)
+    if (base_) UnmapViewOfFile(base_);
+    if (mapping_) CloseHandle(static_cast<HANDLE>(mapping_));
+#else
+    if (base_) munmap(const_cast<unsigned char*>(base_), size_);
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// Validation: everything a draw or a name lookup can touch is checked once,
+// and so are the ranges and weights a roll feeds to the RNG.
+
+static bool inFile(std::uint64_t offset, std::uint64_t count, std::size_t elem, std::size_t size) {
+    return offset % 8 == 0 && offset <= size && count <= (size - offset) / elem;
+}
+
+bool ContentPack::validate() const {
+    const PackHeader& h = header();
+    if (std::memcmp(h.magic, "OBPK", 4) != 0 || h.version != PackHeader::kVersion ||
+        h.byteOrder != PackHeader::kByteOrder || h.fileSize != size_) return false;
+
+    auto tableOk = [&](const PackTable& t, std::size_t recSize) {
+        if (t.count == 0) return false;   // aliasPick reads entry 0 regardless
+        if (!inFile(t.records, t.count, recSize, size_) || !inFile(t.weights, t.count, sizeof(double), size_) ||
+            !inFile(t.cuts, t.count, sizeof(std::uint64_t), size_) ||
+            !inFile(t.aliases, t.count, sizeof(std::uint32_t), size_)) return false;
+        const std::uint32_t* alias = at<std::uint32_t>(t.aliases);
+        for (std::uint32_t i = 0; i < t.count; ++i) if (alias[i] >= t.count) return false;
+        return true;
+    };
+    if (!tableOk(h.dropType, sizeof(std::uint32_t)) || !tableOk(h.rarity, sizeof(std::uint32_t)) ||
+        !tableOk(h.weaponBases, sizeof(PackWeaponBase)) || !tableOk(h.gearBases, sizeof(PackGearBase)) ||
+        !inFile(h.prefixes.offset, h.prefixes.count, sizeof(PackAffix), size_) ||
+        !inFile(h.suffixes.offset, h.suffixes.count, sizeof(PackAffix), size_) ||
+        !inFile(h.strings.offset, h.strings.count, 1, size_)) return false;
+
+    auto strOk = [&](PackString s) { return s.offset <= h.strings.count && s.length <= h.strings.count - s.offset; };
+    for (std::uint32_t i = 0; i < h.rarity.count; ++i) {
+        if (records<std::uint32_t>(h.rarity)[i] > static_cast<std::uint32_t>(Rarity::Legendary)) return false;
+    }
+    for (std::uint32_t i = 0; i < h.weaponBases.count; ++i) {
+        const PackWeaponBase& b = records<PackWeaponBase>(h.weaponBases)[i];
+        if (!strOk(b.name) || b.baseMin > b.baseMax) return false;
+    }
+    for (std::uint32_t i = 0; i < h.gearBases.count; ++i) {
+        const PackGearBase& g = records<PackGearBase>(h.gearBases)[i];
+        if (!strOk(g.name) || g.slot > static_cast<std::uint32_t>(Slot::Ring2) || g.armorMin > g.armorMax) {
+            return false;
+        }
+    }
+    for (const PackRange* r : {&h.prefixes, &h.suffixes}) {
+        for (std::uint32_t i = 0; i < r->count; ++i) {
+            const PackAffix& a = records<PackAffix>(*r)[i];
+            if (!strOk(a.name) || a.flatMin > a.flatMax || !std::isfinite(a.weight) || a.weight <= 0.0) return false;
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Draws
+
+std::size_t ContentPack::pick(const PackTable& t, core::RNG& rng) const {
+    return core::aliasPick(at<std::uint64_t>(t.cuts), at<std::uint32_t>(t.aliases), t.count, rng);
+}
+
+int ContentPack::pickDropType(core::RNG& rng) const {
+    const PackTable& t = header().dropType;
+    return static_cast<int>(records<std::uint32_t>(t)[pick(t, rng)]);
+}
+
+Rarity ContentPack::pickRarity(core::RNG& rng) const {
+    const PackTable& t = header().rarity;
+    return static_cast<Rarity>(records<std::uint32_t>(t)[pick(t, rng)]);
+}
+
+const PackWeaponBase& ContentPack::pickWeaponBase(core::RNG& rng) const {
+    const PackTable& t = header().weaponBases;
+    return records<PackWeaponBase>(t)[pick(t, rng)];
+}
+
+const PackGearBase& ContentPack::pickGearBase(core::RNG& rng) const {
+    const PackTable& t = header().gearBases;
+    return records<PackGearBase>(t)[pick(t, rng)];
+}
+
+// ---------------------------------------------------------------------------
+// Writing
+
+namespace {
+
+// Builds the file image in memory; sections are appended 8-byte aligned.
+struct PackWriter {
+    std::vector<unsigned char> bytes = std::vector<unsigned char>(sizeof(PackHeader));
+    std::string strings;
+
+    template<typename T>
+    std::uint64_t append(const T* data, std::size_t n) {
+        bytes.resize((bytes.size() + 7) & ~std::size_t(7));
+        const std::uint64_t off = bytes.size();
+        const auto* p = reinterpret_cast<const unsigned char*>(data);
+        bytes.insert(bytes.end(), p, p + n * sizeof(T));
+        return off;
+    }
+
+    PackString str(const std::string& s) {
+        const PackString r{static_cast<std::uint32_t>(strings.size()), static_cast<std::uint32_t>(s.size())};
+        strings += s;
+        return r;
+    }
+
+    template<typename T, typename Rec>
+    PackTable table(const core::WeightedTable<T>& wt, const std::vector<Rec>& recs) {
+        PackTable t;
+        t.count   = static_cast<std::uint32_t>(recs.size());
+        t.records = append(recs.data(), recs.size());
+        t.weights = append(wt.weights().data(), wt.size());
+        t.cuts    = append(wt.cuts().data(), wt.size());
+        t.aliases = append(wt.aliases().data(), wt.size());
+        return t;
+    }
+
+    PackRange affixes(const AffixPool& pool) {
+        std::vector<PackAffix> recs;
+        for (const AffixTier& t : pool.tiers()) {
+            // A tier's scale is baked into the stored stats, as AffixList
+            // would apply it.
+            AffixList one;
+            one.push_back(t.affix, t.scale);
+            const AffixTotals& a = one.totals();
+            recs.push_back(PackAffix{str(affixDef(t.affix).name), a.flatMin, a.flatMax, a.pctDamage, a.critChance,
+                                     a.attackSpeed, t.weight, t.minLevel, t.maxLevel});
+        }
+        return PackRange{append(recs.data(), recs.size()), static_cast<std::uint32_t>(recs.size()), 0};
+    }
+};
+
+} // namespace
+
+bool writeContentPack(std::ostream& os, const LootTables& lt) {
+    if (lt.pack || lt.builtin) return false;
+    // Every pack table must have entries: validate() rejects empty ones.
+    if (!lt.dropType.built() || !lt.rarity.built() || !lt.bases.built() || !lt.gearBases.built()) return false;
+
+    PackWriter w;
+    PackHeader h;
+
+    std::vector<std::uint32_t> drops, rarities;
+    for (int d : lt.dropType.items()) drops.push_back(static_cast<std::uint32_t>(d));
+    for (Rarity r : lt.rarity.items()) rarities.push_back(static_cast<std::uint32_t>(r));
+    std::vector<PackWeaponBase> weapons;
+    for (const auto& b : lt.bases.items()) weapons.push_back(PackWeaponBase{w.str(b.name), b.baseMin, b.baseMax});
+    std::vector<PackGearBase> gear;
+    for (const auto& g : lt.gearBases.items()) {
+        gear.push_back(PackGearBase{w.str(g.name), static_cast<std::uint32_t>(g.slot), g.armorMin, g.armorMax, 0});
+    }
+
+    h.dropType    = w.table(lt.dropType, drops);
+    h.rarity      = w.table(lt.rarity, rarities);
+    h.weaponBases = w.table(lt.bases, weapons);
+    h.gearBases   = w.table(lt.gearBases, gear);
+    h.prefixes    = w.affixes(lt.prefixes);
+    h.suffixes    = w.affixes(lt.suffixes);
+    h.strings     = PackRange{w.append(w.strings.data(), w.strings.size()),
+                              static_cast<std::uint32_t>(w.strings.size()), 0};
+    w.bytes.resize((w.bytes.size() + 7) & ~std::size_t(7));
+    h.fileSize = w.bytes.size();
+    std::memcpy(w.bytes.data(), &h, sizeof h);
+
+    os.write(reinterpret_cast<const char*>(w.bytes.data()), static_cast<std::streamsize>(w.bytes.size()));
+    return static_cast<bool>(os);
+}
+
+bool saveContentPack(const std::string& path, const LootTables& lt) {
+    std::ofstream f(path, std::ios::binary);
+    return f && writeContentPack(f, lt);
+}
+
+bool openContentPack(const std::string& path, LootTables& out) {
+    auto pack = ContentPack::open(path);
+    if (!pack) return false;
+
+    const PackHeader& h = pack->header();
+    auto intern = [&](const PackRange& r, AffixPool& pool) {
+        for (std::uint32_t i = 0; i < r.count; ++i) {
+            const PackAffix& a = pack->records<PackAffix>(r)[i];
+            const AffixId id = internAffix(Affix{std::string(pack->str(a.name)), a.flatMin, a.flatMax,
+                                                 a.pctDamage, a.critChance, a.attackSpeed});
+            if (id == kNoAffix) return false;   // registry full
+            pool.add(id, a.weight, a.minLevel, a.maxLevel);
+        }
+        pool.build();
+        return true;
+    };
+    LootTables lt;
+    if (!intern(h.prefixes, lt.prefixes) || !intern(h.suffixes, lt.suffixes)) return false;
+    lt.pack = std::move(pack);
+    out = std::move(lt);
+    return true;
+}
+
+} // namespace game
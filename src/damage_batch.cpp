@@ -0,0 +1,154 @@
+#include "game/damage_batch.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define OATHBOUND_AVX2_KERNEL 1
+#define OATHBOUND_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && defined(_M_X64)
+#define OATHBOUND_AVX2_KERNEL 1
+#define OATHBOUND_TARGET_AVX2
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace game {
+
+// Profile fields for swing k: a column, or one value broadcast to all.
+struct OneProfile {
+    const SwingProfile& p;
+    double scale(std::size_t) const    { return p.scale; }
+    double critC(std::size_t) const    { return p.critC; }
+    double critMult(std::size_t) const { return p.critMult; }
+};
+
+struct ColumnProfile {
+    const SwingColumns& c;
+    double scale(std::size_t k) const    { return c.scale[k]; }
+    double critC(std::size_t k) const    { return c.critC[k]; }
+    double critMult(std::size_t k) const { return c.critMult[k]; }
+};
+
+template<typename Profile>
+static void damageScalar(const Profile& p, const int* __restrict base, const double* __restrict critU,
+                         int* __restrict out, std::size_t from, std::size_t n) {
+    for (std::size_t k = from; k < n; ++k) {
+        double scaled = base[k] * p.scale(k);
+        if (critU[k] < p.critC(k)) scaled *= p.critMult(k);
+        out[k] = std::max(0, static_cast<int>(std::round(scaled)));
+    }
+}
+
+#if defined(OATHBOUND_AVX2_KERNEL)
+
+static bool cpuHasAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int r[4];
+    __cpuid(r, 0);
+    if (r[0] < 7) return false;
+    __cpuid(r, 1);
+    const bool osxsave = (r[2] & (1 << 27)) != 0, avx = (r[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;   // OS saves YMM state
+    __cpuidex(r, 7, 0);
+    return (r[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+// Broadcast or load the four profile values starting at swing k.
+struct OneProfileAvx2 {
+    __m256d scale, critC, critMult;
+    OATHBOUND_TARGET_AVX2 explicit OneProfileAvx2(const SwingProfile& p)
+        : scale(_mm256_set1_pd(p.scale)), critC(_mm256_set1_pd(p.critC)), critMult(_mm256_set1_pd(p.critMult)) {}
+    OATHBOUND_TARGET_AVX2 __m256d loadScale(std::size_t) const    { return scale; }
+    OATHBOUND_TARGET_AVX2 __m256d loadCritC(std::size_t) const    { return critC; }
+    OATHBOUND_TARGET_AVX2 __m256d loadCritMult(std::size_t) const { return critMult; }
+};
+
+struct ColumnProfileAvx2 {
+    const SwingColumns& c;
+    OATHBOUND_TARGET_AVX2 __m256d loadScale(std::size_t k) const    { return _mm256_loadu_pd(c.scale + k); }
+    OATHBOUND_TARGET_AVX2 __m256d loadCritC(std::size_t k) const    { return _mm256_loadu_pd(c.critC + k); }
+    OATHBOUND_TARGET_AVX2 __m256d loadCritMult(std::size_t k) const { return _mm256_loadu_pd(c.critMult + k); }
+};
+
+// Four swings per step. std::round is trunc(x) + (x - trunc(x) >= 0.5) for
+// x >= 0 (the subtraction is exact), and anything negative ends up 0 after
+// the clamp either way, so max(t, 0) covers both.
+template<typename Wide>
+OATHBOUND_TARGET_AVX2 static std::size_t damageAvx2(const Wide& p, const int* base, const double* critU, int* out,
+                                                    std::size_t n) {
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d one  = _mm256_set1_pd(1.0);
+    const __m256d zero = _mm256_setzero_pd();
+    std::size_t k = 0;
+    for (; k + 4 <= n; k += 4) {
+        __m256d x = _mm256_mul_pd(_mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(base + k))),
+                                  p.loadScale(k));
+        const __m256d crit = _mm256_cmp_pd(_mm256_loadu_pd(critU + k), p.loadCritC(k), _CMP_LT_OQ);
+        x = _mm256_blendv_pd(x, _mm256_mul_pd(x, p.loadCritMult(k)), crit);
+        __m256d t = _mm256_round_pd(x, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+        const __m256d up = _mm256_cmp_pd(_mm256_sub_pd(x, t), half, _CMP_GE_OQ);
+        t = _mm256_max_pd(_mm256_add_pd(t, _mm256_and_pd(up, one)), zero);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + k), _mm256_cvttpd_epi32(t));
+    }
+    return k;
+}
+
+#endif
+
+DamageKernel bestDamageKernel() {
+#if defined(OATHBOUND_AVX2_KERNEL)
+    static const DamageKernel best = cpuHasAvx2() ? DamageKernel::Avx2 : DamageKernel::Scalar;
+    return best;
+#else
+    return DamageKernel::Scalar;
+#endif
+}
+
+// An Avx2 request on a CPU without it runs the scalar loop.
+void damageBatch(const SwingProfile& p, const int* base, const double* critU, int* out, std::size_t n,
+                 DamageKernel k) {
+    std::size_t done = 0;
+#if defined(OATHBOUND_AVX2_KERNEL)
+    if (k == DamageKernel::Avx2 && bestDamageKernel() == DamageKernel::Avx2) {
+        done = damageAvx2(OneProfileAvx2(p), base, critU, out, n);
+    }
+#else
+    (void)k;
+#endif
+    damageScalar(OneProfile{p}, base, critU, out, done, n);
+}
+
+void damageBatch(const SwingColumns& c, const int* base, const double* critU, int* out, std::size_t n,
+                 DamageKernel k) {
+    std::size_t done = 0;
+#if defined(OATHBOUND_AVX2_KERNEL)
+    if (k == DamageKernel::Avx2 && bestDamageKernel() == DamageKernel::Avx2) {
+        done = damageAvx2(ColumnProfileAvx2{c}, base, critU, out, n);
+    }
+#else
+    (void)k;
+#endif
+    damageScalar(ColumnProfile{c}, base, critU, out, done, n);
+}
+
+void rollDamageBatch(const SwingProfile& p, core::RNG& rng, int* out, std::size_t n) {
+    // Inputs are drawn in rollDamage()'s order, base then crit per swing, a
+    // chunk at a time.
+    constexpr std::size_t kChunk = 256;
+    int    base[kChunk];
+    double critU[kChunk];
+    for (std::size_t at = 0; at < n; at += kChunk) {
+        const std::size_t m = std::min(kChunk, n - at);
+        for (std::size_t k = 0; k < m; ++k) {
+            base[k]  = rng.i(p.minDmg, p.maxDmg);
+            critU[k] = rng.unit();
+        }
+        damageBatch(p, base, critU, out + at, m);
+    }
+}
+
+} // namespace game
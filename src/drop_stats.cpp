@@ -0,0 +1,229 @@
+#include "game/drop_stats.hpp"
+#include "game/combat_math.hpp"
+#include <algorithm>
+#include <ostream>
+#include <tuple>
+
+namespace game {
+
+static constexpr std::uint16_t kNoBase = 0xFFFF;
+
+static std::uint64_t fnv1a(std::string_view s) {
+    std::uint64_t h = 0xcbf29ce484222325ull;
+    for (char c : s) { h ^= static_cast<unsigned char>(c); h *= 0x100000001b3ull; }
+    return h;
+}
+
+bool DropStats::Key::operator==(const Key& o) const {
+    return base == o.base && rarity == o.rarity && kind == o.kind && affixes == o.affixes;
+}
+
+static std::uint64_t hashOf(std::uint16_t base, std::uint8_t rarity, std::uint8_t kind,
+                            const std::array<AffixId, AffixList::kCapacity>& a) {
+    std::uint64_t lo = base | std::uint64_t(rarity) << 16 | std::uint64_t(kind) << 24 |
+                       std::uint64_t(a[0]) << 32 | std::uint64_t(a[1]) << 48;
+    std::uint64_t hi = a[2] | std::uint64_t(a[3]) << 16;
+    std::uint64_t h = (lo ^ (hi * 0x9E3779B97F4A7C15ull)) * 0xBF58476D1CE4E5B9ull;
+    return h ^ (h >> 31);
+}
+
+DropStats::DropStats(std::size_t maxCombos) : maxCombos_(std::max<std::size_t>(1, maxCombos)) {
+    std::size_t cap = 2;
+    while (cap < 2 * maxCombos_) cap <<= 1;
+    table_.resize(cap);
+}
+
+std::uint16_t DropStats::baseOf(std::string_view name) {
+    const std::uint64_t h = fnv1a(name);
+    for (std::size_t i = 0; i < bases_.size(); ++i) {
+        if (baseHash_[i] == h && bases_[i] == name) return static_cast<std::uint16_t>(i);
+    }
+    if (bases_.size() >= kNoBase) return kNoBase;
+    bases_.emplace_back(name);
+    baseHash_.push_back(h);
+    return static_cast<std::uint16_t>(bases_.size() - 1);
+}
+
+void DropStats::addCombo(const Key& k, std::uint64_t n) {
+    const std::size_t mask = table_.size() - 1;
+    for (std::size_t i = hashOf(k.base, k.rarity, k.kind, k.affixes) & mask;; i = (i + 1) & mask) {
+        Entry& e = table_[i];
+        if (e.count == 0) {
+            if (used_ == maxCombos_) { otherDrops_ += n; return; }
+            e.key = k;
+            ++used_;
+        } else if (!(e.key == k)) {
+            continue;
+        }
+        e.count += n;
+        return;
+    }
+}
+
+void DropStats::addDrop(const Item& it) {
+    ++drops_;
+    ++byRarity_[static_cast<std::size_t>(it.rarity)];
+    ++byKind_[it.isWeapon() ? 0 : 1];
+    if (it.isWeapon()) weaponDPR_.add(expectedDPR(it));
+
+    Key k;
+    k.base = baseOf(std::string_view(it.name.data(), it.name.size()));
+    if (k.base == kNoBase) { ++otherDrops_; return; }
+    k.rarity = static_cast<std::uint8_t>(it.rarity);
+    k.kind   = it.isWeapon() ? 0 : 1;
+    k.affixes.fill(kNoAffix);
+    std::copy(it.affixes.begin(), it.affixes.end(), k.affixes.begin());
+    std::sort(k.affixes.begin(), k.affixes.begin() + it.affixes.size());
+    addCombo(k, 1);
+}
+
+void DropStats::addEvent(const CombatEvent& e) {
+    switch (e.kind) {
+        case CombatEventKind::Hit:
+            if (e.attacker == kPlayerActor) addDealt(e.damage); else addTaken(e.damage);
+            break;
+        case CombatEventKind::Slain:
+            if (e.target != kPlayerActor) addKills();
+            break;
+        default:
+            break;
+    }
+}
+
+void DropStats::merge(const DropStats& o) {
+    drops_      += o.drops_;
+    kills_      += o.kills_;
+    otherDrops_ += o.otherDrops_;
+    for (std::size_t r = 0; r < kRarities; ++r) byRarity_[r] += o.byRarity_[r];
+    for (std::size_t k = 0; k < byKind_.size(); ++k) byKind_[k] += o.byKind_[k];
+    dealt_.merge(o.dealt_);
+    taken_.merge(o.taken_);
+    weaponDPR_.merge(o.weaponDPR_);
+
+    // Base indices are per instance, so keys are remapped by name.
+    for (const Entry& e : o.table_) {
+        if (e.count == 0) continue;
+        Key k = e.key;
+        k.base = baseOf(o.bases_[e.key.base]);
+        if (k.base == kNoBase) otherDrops_ += e.count;
+        else addCombo(k, e.count);
+    }
+}
+
+DropStats::Combo DropStats::comboOf(const Entry& e) const {
+    Combo c;
+    c.kind   = e.key.kind ? ItemKind::Gear : ItemKind::Weapon;
+    c.rarity = static_cast<Rarity>(e.key.rarity);
+    c.base   = bases_[e.key.base];
+    for (AffixId id : e.key.affixes) if (id != kNoAffix) c.affixes.push_back(id);
+    c.count  = e.count;
+    return c;
+}
+
+std::vector<DropStats::Combo> DropStats::combos() const {
+    std::vector<Combo> out;
+    out.reserve(used_);
+    for (const Entry& e : table_) if (e.count) out.push_back(comboOf(e));
+    std::sort(out.begin(), out.end(), [](const Combo& a, const Combo& b) {
+        return std::tie(b.count, a.kind, a.rarity, a.base, a.affixes) <
+               std::tie(a.count, b.kind, b.rarity, b.base, b.affixes);
+    });
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// Export
+
+static const char* kindName(ItemKind k) { return k == ItemKind::Weapon ? "Weapon" : "Gear"; }
+
+static void csvField(std::ostream& os, const std::string& s) {
+    if (s.find_first_of(",\"\n") == std::string::npos) { os << s; return; }
+    os << '"';
+    for (char c : s) { if (c == '"') os << '"'; os << c; }
+    os << '"';
+}
+
+static void jsonString(std::ostream& os, const std::string& s) {
+    os << '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\') os << '\\';
+        os << c;
+    }
+    os << '"';
+}
+
+static std::string affixNames(const std::vector<AffixId>& ids) {
+    std::string s;
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        if (i) s += " + ";
+        s += affixDef(ids[i]).name;
+    }
+    return s;
+}
+
+void DropStats::writeCsv(std::ostream& os) const {
+    const auto prec = os.precision(10);
+    os << "kind,rarity,base,affixes,affix_ids,count,share,kills_per_drop\n";
+    for (const Combo& c : combos()) {
+        os << kindName(c.kind) << ',' << rarityName(c.rarity) << ',';
+        csvField(os, c.base);
+        os << ',';
+        csvField(os, affixNames(c.affixes));
+        os << ',';
+        for (std::size_t i = 0; i < c.affixes.size(); ++i) os << (i ? " " : "") << c.affixes[i];
+        os << ',' << c.count << ',' << double(c.count) / double(drops_) << ',';
+        if (kills_) os << double(kills_) / double(c.count);
+        os << '\n';
+    }
+    os.precision(prec);
+}
+
+static void writeSketch(std::ostream& os, const char* name, const core::QuantileSketch& s) {
+    os << "  \"" << name << "\": {\"count\": " << s.count() << ", \"mean\": " << s.mean()
+       << ", \"min\": " << s.lowest() << ", \"max\": " << s.highest()
+       << ", \"p50\": " << s.quantile(0.50) << ", \"p90\": " << s.quantile(0.90)
+       << ", \"p99\": " << s.quantile(0.99) << ",\n    \"bins\": [";
+    bool first = true;
+    for (std::size_t i = 0; i < s.bins(); ++i) {
+        if (!s.binCount(i)) continue;
+        os << (first ? "" : ", ") << '[' << core::QuantileSketch::lowerEdge(i) << ", " << s.binCount(i) << ']';
+        first = false;
+    }
+    os << "]},\n";
+}
+
+void DropStats::writeJson(std::ostream& os) const {
+    const auto prec = os.precision(10);
+    os << "{\n  \"drops\": " << drops_ << ", \"kills\": " << kills_ << ", \"other_drops\": " << otherDrops_
+       << ", \"combos\": " << used_ << ", \"max_combos\": " << maxCombos_ << ",\n  \"by_rarity\": {";
+    for (std::size_t r = 0; r < kRarities; ++r) {
+        os << (r ? ", " : "") << '"' << rarityName(static_cast<Rarity>(r)) << "\": " << byRarity_[r];
+    }
+    os << "},\n  \"by_kind\": {\"Weapon\": " << byKind_[0] << ", \"Gear\": " << byKind_[1] << "},\n";
+    writeSketch(os, "dealt", dealt_);
+    writeSketch(os, "taken", taken_);
+    writeSketch(os, "weapon_dpr", weaponDPR_);
+
+    os << "  \"combinations\": [";
+    const std::vector<Combo> cs = combos();
+    for (std::size_t i = 0; i < cs.size(); ++i) {
+        const Combo& c = cs[i];
+        os << (i ? ",\n" : "\n") << "    {\"kind\": \"" << kindName(c.kind) << "\", \"rarity\": \""
+           << rarityName(c.rarity) << "\", \"base\": ";
+        jsonString(os, c.base);
+        os << ", \"affixes\": [";
+        for (std::size_t j = 0; j < c.affixes.size(); ++j) {
+            if (j) os << ", ";
+            jsonString(os, affixDef(c.affixes[j]).name);
+        }
+        os << "], \"affix_ids\": [";
+        for (std::size_t j = 0; j < c.affixes.size(); ++j) os << (j ? ", " : "") << c.affixes[j];
+        os << "], \"count\": " << c.count;
+        if (kills_) os << ", \"kills_per_drop\": " << double(kills_) / double(c.count);
+        os << '}';
+    }
+    os << (cs.empty() ? "]\n}\n" : "\n  ]\n}\n");
+    os.precision(prec);
+}
+
+} // namespace game
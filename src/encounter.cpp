@@ -8,65 +8,87 @@ namespace game {
 
 void Encounter::run() {
     // Ensure actor weapon matches inventory at start if equipped
-    if (const Weapon* eq = inventory.equipped()) {
+    if (const Item* eq = inventory.equipped()) {
         player.weapon = *eq;
     }
-    std::cout << "You wield " << player.weapon.label() << "\n\n";
 
-    int round = 1;
+    // Events go to the caller's ring untouched; without one they pass through
+    // a local ring that is printed after every round.
+    const bool print = events == nullptr;
+    CombatEventRing local(print ? 64 + 8 * (enemies.size() + 1) : 2);
+    CombatEventRing& out = print ? local : *events;
+    const CombatRoster roster = print ? CombatRoster::of(player, enemies) : CombatRoster{};
+    auto flush = [&]{
+        if (!print) return;
+        out.drain([&](const CombatEvent& e){ formatEvent(std::cout, e, roster, &inventory); std::cout << "\n"; });
+    };
+    if (print) std::cout << "You wield " << player.weapon.label() << "\n\n";
+
+    std::uint32_t round = 1;
     auto anyAlive = [&]{ for (const auto& e : enemies) if (e.alive()) return true; return false; };
 
     while (player.alive() && anyAlive()) {
-        std::cout << "=== Round " << round++ << " ===\n";
+        CombatEvent ev;
+        ev.round = round;
+        ev.kind  = CombatEventKind::RoundStart;
+        out.push(ev);
 
         // Player turn
         auto it = std::find_if(enemies.begin(), enemies.end(), [](const Actor& e){ return e.alive(); });
         if (it != enemies.end()) {
             Actor& target = *it;
-            int hits = std::max(1, static_cast<int>(std::round(player.weapon.attackSpeed())));
+            const std::uint16_t targetId = enemyActor(static_cast<std::size_t>(it - enemies.begin()));
+            int hits = swingsPerRound(player.weapon);
             for (int h = 0; h < hits && target.alive(); ++h) {
-                int dmg = player.attack(target, rng);
+                bool crit = false;
+                int dmg = player.attack(target, rng, 0.0, 0.0, &crit);
                 target.hp -= dmg;
-                std::cout << "You hit " << target.name << " for " << dmg
-                          << " (" << std::max(0, target.hp) << "/" << target.maxHP << ")\n";
+                out.push(CombatEvent{round, CombatEventKind::Hit, crit ? kEventCrit : std::uint8_t(0),
+                                     kPlayerActor, targetId, dmg, target.hp, kNoDrop});
             }
             if (!target.alive()) {
-                std::cout << target.name << " is slain!\n";
+                out.push(CombatEvent{round, CombatEventKind::Slain, 0, kPlayerActor, targetId, 0, 0, kNoDrop});
 
                 // Drop → add to inventory
-                Weapon drop = loots.rollWeapon(rng, /*level*/1);
-                std::cout << "Loot dropped: " << drop.label() << "\n";
-                std::size_t idx = inventory.add(std::move(drop));
+                Item drop = loots.rollWeapon(rng, /*level*/1);
+                std::size_t idx = inventory.addWeapon(std::move(drop));
+                out.push(CombatEvent{round, CombatEventKind::Drop, 0, kNoActor, targetId, 0, 0,
+                                     static_cast<std::uint32_t>(idx)});
 
                 // Compare DPR and auto-equip if better
                 const double cur = expectedDPR(player.weapon);
-                const double cand = expectedDPR(inventory.at(idx));
+                const double cand = expectedDPR(inventory.weaponAt(idx));
                 if (cand > cur) {
                     inventory.equip(idx);
                     player.weapon = *inventory.equipped(); // sync
-                    std::cout << "Auto-equipped better weapon ("
-                              << cand << " DPR > " << cur << " DPR).\n";
+                    out.push(CombatEvent{round, CombatEventKind::AutoEquip, 0, kPlayerActor, kNoActor, 0, 0,
+                                         static_cast<std::uint32_t>(idx)});
                 }
             }
         }
 
         // Enemies' turn
-        for (auto& e : enemies) {
+        for (std::size_t i = 0; i < enemies.size(); ++i) {
+            Actor& e = enemies[i];
             if (!e.alive() || !player.alive()) continue;
-            int hits = std::max(1, static_cast<int>(std::round(e.weapon.attackSpeed())));
+            int hits = swingsPerRound(e.weapon);
             for (int h = 0; h < hits && player.alive(); ++h) {
-                int dmg = e.attack(player, rng);
+                bool crit = false;
+                int dmg = e.attack(player, rng, 0.0, 0.0, &crit);
                 player.hp -= dmg;
-                std::cout << e.name << " hits you for " << dmg
-                          << " (You: " << std::max(0, player.hp) << "/" << player.maxHP << ")\n";
+                out.push(CombatEvent{round, CombatEventKind::Hit, crit ? kEventCrit : std::uint8_t(0),
+                                     enemyActor(i), kPlayerActor, dmg, player.hp, kNoDrop});
             }
         }
 
-        std::cout << "\n";
+        flush();
+        if (print) std::cout << "\n";
+        ++round;
     }
 
-    std::cout << (player.alive() ? "Victory! You survived with " + std::to_string(player.hp) + " HP.\n"
-                                 : "Defeat. You died.\n");
+    out.push(CombatEvent{round - 1, player.alive() ? CombatEventKind::Victory : CombatEventKind::Defeat, 0,
+                         kPlayerActor, kNoActor, 0, player.hp, kNoDrop});
+    flush();
 }
 
 } // namespace game
@@ -0,0 +1,168 @@
+#include "game/fight_predictor.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace game {
+
+static double meanOf(const std::vector<double>& dist) {
+    double n = 0.0, sum = 0.0;
+    for (std::size_t i = 0; i < dist.size(); ++i) {
+        n   += dist[i];
+        sum += double(i) * dist[i];
+    }
+    return n > 0.0 ? sum / n : 0.0;
+}
+
+double FightPrediction::meanRoundsToWin() const { return meanOf(roundsToWin); }
+double FightPrediction::meanHpOnWin() const     { return meanOf(hpOnWin); }
+
+std::vector<double> damageDistribution(const SwingProfile& p, int armor) {
+    std::vector<double> dist(1, 0.0);
+    auto add = [&](double scaled, double w) {
+        const int d = applyArmor(std::max(0, static_cast<int>(std::round(scaled))), armor);
+        if (static_cast<std::size_t>(d) >= dist.size()) dist.resize(static_cast<std::size_t>(d) + 1, 0.0);
+        dist[static_cast<std::size_t>(d)] += w;
+    };
+    const double each = 1.0 / double(p.maxDmg - p.minDmg + 1);
+    for (int roll = p.minDmg; roll <= p.maxDmg; ++roll) {
+        const double scaled = roll * p.scale;
+        if (p.critC < 1.0) add(scaled, each * (1.0 - p.critC));
+        if (p.critC > 0.0) add(scaled * p.critMult, each * p.critC);
+    }
+    return dist;
+}
+
+// a (*) b with every total >= cap folded into index cap.
+static std::vector<double> convolveCapped(const std::vector<double>& a, const std::vector<double>& b,
+                                          std::size_t cap) {
+    std::vector<double> out(std::min(a.size() + b.size() - 1, cap + 1), 0.0);
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (a[i] == 0.0) continue;
+        for (std::size_t j = 0; j < b.size(); ++j) out[std::min(i + j, cap)] += a[i] * b[j];
+    }
+    return out;
+}
+
+FightPrediction predictFight(const Actor& player, const std::vector<Actor>& enemies,
+                             int maxRounds, double cutoff) {
+    FightPrediction r;
+    maxRounds = std::max(0, maxRounds);
+    r.roundsToWin.assign(static_cast<std::size_t>(maxRounds) + 1, 0.0);
+    r.hpOnWin.assign(static_cast<std::size_t>(std::max(0, player.maxHP)) + 1, 0.0);
+    r.killRound.assign(enemies.size(), std::vector<double>(static_cast<std::size_t>(maxRounds) + 1, 0.0));
+
+    // Enemies that start dead never act and are never targeted.
+    std::vector<std::size_t> live;
+    for (std::size_t i = 0; i < enemies.size(); ++i) if (enemies[i].alive()) live.push_back(i);
+
+    auto win = [&](int round, int hp, double m) {
+        r.pWin += m;
+        r.roundsToWin[static_cast<std::size_t>(round)] += m;
+        r.hpOnWin[static_cast<std::size_t>(std::clamp(hp, 0, player.maxHP))] += m;
+    };
+    if (!player.alive()) { r.pLoss = 1.0; return r; }
+    if (live.empty())    { win(0, player.hp, 1.0); return r; }
+
+    const int P = player.hp;
+    const std::size_t F = live.size();
+    const SwingProfile playerSwing = makeSwingProfile(player.weapon);
+    const int playerHits = swingsPerRound(player.weapon);
+
+    // Per target f: the player's swing distribution against it, and the
+    // damage all enemies from f on deal in one round (>= P folded into P).
+    std::vector<std::vector<double>> hitDist(F), enemyRound(F + 1);
+    enemyRound[F] = {1.0};
+    for (std::size_t f = F; f-- > 0;) {
+        const Actor& e = enemies[live[f]];
+        hitDist[f] = damageDistribution(playerSwing, e.armor);
+        const std::vector<double> swing = damageDistribution(makeSwingProfile(e.weapon), player.armor);
+        std::vector<double> acc = enemyRound[f + 1];
+        for (int h = swingsPerRound(e.weapon); h > 0; --h) acc = convolveCapped(acc, swing, static_cast<std::size_t>(P));
+        enemyRound[f] = std::move(acc);
+    }
+
+    // state[f][(p-1)*T + (t-1)]: P(target f has t hp and the player p).
+    std::vector<int> T(F);
+    for (std::size_t f = 0; f < F; ++f) T[f] = enemies[live[f]].hp;
+    std::vector<std::vector<double>> state(F), next(F);
+    for (std::size_t f = 0; f < F; ++f) {
+        state[f].assign(static_cast<std::size_t>(P) * T[f], 0.0);
+        next[f].assign(state[f].size(), 0.0);
+    }
+    state[0][static_cast<std::size_t>(P - 1) * T[0] + (T[0] - 1)] = 1.0;
+    double undecided = 1.0;
+
+    std::vector<double> col, tmp;
+    for (int round = 1; round <= maxRounds && undecided > 0.0; ++round) {
+        if (undecided < cutoff) { r.pTruncated = undecided; undecided = 0.0; break; }
+
+        // Player turn: `playerHits` swings at the current target; a kill moves
+        // the mass to the next target at full hp (or wins the fight).
+        for (std::size_t f = 0; f < F; ++f) std::fill(next[f].begin(), next[f].end(), 0.0);
+        for (std::size_t f = 0; f < F; ++f) {
+            const std::size_t Tf = static_cast<std::size_t>(T[f]);
+            const std::vector<double>& D = hitDist[f];
+            for (int p = 1; p <= P; ++p) {
+                const double* src = &state[f][static_cast<std::size_t>(p - 1) * Tf];
+                col.assign(src, src + Tf);
+                double killed = 0.0;
+                for (int h = 0; h < playerHits; ++h) {
+                    tmp.assign(Tf, 0.0);
+                    for (std::size_t t = 0; t < Tf; ++t) {
+                        const double m = col[t];
+                        if (m == 0.0) continue;
+                        for (std::size_t d = 0; d < D.size(); ++d) {
+                            if (d > t) killed += m * D[d];
+                            else       tmp[t - d] += m * D[d];
+                        }
+                    }
+                    col.swap(tmp);
+                }
+                double* dst = &next[f][static_cast<std::size_t>(p - 1) * Tf];
+                for (std::size_t t = 0; t < Tf; ++t) dst[t] += col[t];
+                if (killed == 0.0) continue;
+                r.killRound[live[f]][static_cast<std::size_t>(round)] += killed;
+                if (f + 1 == F) {
+                    win(round, p, killed);
+                    undecided -= killed;
+                } else {
+                    const std::size_t Tn = static_cast<std::size_t>(T[f + 1]);
+                    next[f + 1][static_cast<std::size_t>(p - 1) * Tn + (Tn - 1)] += killed;
+                }
+            }
+        }
+
+        // Enemies' turn: subtract one round of pack damage from the player.
+        for (std::size_t f = 0; f < F; ++f) {
+            std::fill(state[f].begin(), state[f].end(), 0.0);
+            const std::size_t Tf = static_cast<std::size_t>(T[f]);
+            const std::vector<double>& E = enemyRound[f];
+            for (int p = 1; p <= P; ++p) {
+                const double* src = &next[f][static_cast<std::size_t>(p - 1) * Tf];
+                double mass = 0.0;
+                for (std::size_t t = 0; t < Tf; ++t) mass += src[t];
+                if (mass == 0.0) continue;
+                for (std::size_t d = 0; d < E.size(); ++d) {
+                    if (E[d] == 0.0) continue;
+                    if (static_cast<int>(d) >= p) {
+                        r.pLoss   += mass * E[d];
+                        undecided -= mass * E[d];
+                        continue;
+                    }
+                    double* dst = &state[f][static_cast<std::size_t>(p - 1 - static_cast<int>(d)) * Tf];
+                    for (std::size_t t = 0; t < Tf; ++t) dst[t] += src[t] * E[d];
+                }
+            }
+        }
+    }
+    // Whatever is left after the last round timed out; recount it instead of
+    // trusting the running total, which carries rounding drift.
+    if (r.pTruncated == 0.0) {
+        double left = 0.0;
+        for (const auto& s : state) for (double m : s) left += m;
+        r.pTimeout = left;
+    }
+    return r;
+}
+
+} // namespace game
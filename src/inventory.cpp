@@ -1,5 +1,4 @@
 #include "game/inventory.hpp"
-#include <limits>
 #include <algorithm>
 
 namespace game {
@@ -7,21 +6,63 @@ namespace game {
 std::size_t Inventory::addWeapon(Item w) {
     if (!w.isWeapon()) return npos;
     weapons_.push_back(std::move(w));
+    weaponSlot_.push_back(newSlot(false, weapons_.size() - 1));
+    if (!columnsDirty_) weaponCols_.push_back(weapons_.back());
     return weapons_.size() - 1;
 }
 
 std::size_t Inventory::addGear(Item g) {
     if (g.isWeapon()) return npos;
     gear_.push_back(std::move(g));
+    gearSlot_.push_back(newSlot(true, gear_.size() - 1));
     return gear_.size() - 1;
 }
 
+static GearBonuses bonusOf(const Item& g) {
+    return GearBonuses{g.armorBonus, g.pctDamage(), g.critChance(), g.attackSpeed()};
+}
+
+// Order the slot contributions are summed in.
+static constexpr Slot kGearSlots[] = {
+    Slot::Armor, Slot::Helmet, Slot::Boots, Slot::Belt, Slot::Amulet, Slot::Ring1, Slot::Ring2, Slot::Offhand,
+};
+
+void Inventory::setGear(Slot slot, std::size_t idx) {
+    eq_[slot] = idx;
+    slotBonus_[slotIndex(slot)] = idx < gear_.size() ? bonusOf(gear_[idx]) : GearBonuses{};
+    sumBonuses();
+}
+
+void Inventory::sumBonuses() const {
+    // Re-folding the cached per-slot values in a fixed order (rather than
+    // subtracting the old piece) keeps the total independent of equip history.
+    GearBonuses b{0,0.0,0.0,0.0};
+    for (Slot s : kGearSlots) {
+        const GearBonuses& c = slotBonus_[slotIndex(s)];
+        b.armor       += c.armor;
+        b.pctDamage   += c.pctDamage;
+        b.critChance  += c.critChance;
+        b.attackSpeed += c.attackSpeed;
+    }
+    bonuses_ = b;
+}
+
+void Inventory::refreshBonuses() const {
+    for (Slot s : kGearSlots) {
+        const std::size_t idx = eq_[s];
+        slotBonus_[slotIndex(s)] = idx < gear_.size() ? bonusOf(gear_[idx]) : GearBonuses{};
+    }
+    sumBonuses();
+    bonusesDirty_ = false;
+}
+
 bool Inventory::equip(std::size_t idx) {
     if (idx >= weapons_.size()) return false;
     eq_.mainHand = idx;
+    if (eq_.offHandWpn == idx) eq_.offHandWpn = npos;   // moved across, not copied
     if (weapons_[idx].twoHanded) { // occupy both hands
-        eq_.offHandWpn    = npos;
-        eq_.offHandShield = npos;
+        eq_.offHandWpn = npos;
+        if (eq_[Slot::Offhand] != npos) setGear(Slot::Offhand, npos);
     }
     return true;
 }
@@ -29,8 +70,9 @@ bool Inventory::equip(std::size_t idx) {
 bool Inventory::equipOffhand(std::size_t idx) {
     if (idx >= weapons_.size()) return false;
     if (weapons_[idx].twoHanded) return false; // can't put a 2H in off-hand
-    eq_.offHandWpn    = idx;
-    eq_.offHandShield = npos;
+    if (idx == eq_.mainHand) return false;     // one weapon, one hand
+    eq_.offHandWpn = idx;
+    if (eq_[Slot::Offhand] != npos) setGear(Slot::Offhand, npos);
     return true;
 }
 
@@ -44,89 +86,193 @@ const Item* Inventory::equippedOffhand() const {
     return &weapons_[eq_.offHandWpn];
 }
 
-static void setSlotIndex(Inventory::Equipped& eq, Slot slot, std::size_t idx, bool& ok) {
-    switch (slot) {
-        case Slot::Armor:  eq.armor  = idx; break;
-        case Slot::Helmet: eq.helmet = idx; break;
-        case Slot::Boots:  eq.boots  = idx; break;
-        case Slot::Belt:   eq.belt   = idx; break;
-        case Slot::Amulet: eq.amulet = idx; break;
-        case Slot::Ring1:  eq.ring1  = idx; break;
-        case Slot::Ring2:  eq.ring2  = idx; break;
-        case Slot::Offhand: ok = false; return; // handled via offHandShield
-        case Slot::Weapon:  ok = false; return; // use equip()
-    }
-    ok = true;
-}
-
 bool Inventory::equipGear(std::size_t gearIdx) {
     if (gearIdx >= gear_.size()) return false;
     const Item& g = gear_[gearIdx];
 
+    if (g.slot == Slot::Weapon) return false; // use equip()
+
     if (g.slot == Slot::Offhand) { // shield / off-hand gear
-        eq_.offHandShield = gearIdx;
-        eq_.offHandWpn    = npos;
+        eq_.offHandWpn = npos;
+        setGear(Slot::Offhand, gearIdx);
         return true;
     }
 
     if (g.slot == Slot::Ring1 || g.slot == Slot::Ring2) {
-        if (eq_.ring1 == npos) { eq_.ring1 = gearIdx; return true; }
-        if (eq_.ring2 == npos) { eq_.ring2 = gearIdx; return true; }
-        eq_.ring1 = gearIdx; // replace Ring1 by convention
+        // Already on a finger: leave it there rather than wear it twice.
+        if (eq_[Slot::Ring1] == gearIdx || eq_[Slot::Ring2] == gearIdx) return true;
+        // Ring1 first, then Ring2; with both full, replace Ring1 by convention.
+        setGear(eq_[Slot::Ring1] != npos && eq_[Slot::Ring2] == npos ? Slot::Ring2 : Slot::Ring1, gearIdx);
         return true;
     }
 
-    bool ok=false; setSlotIndex(eq_, g.slot, gearIdx, ok);
-    return ok;
+    setGear(g.slot, gearIdx);
+    return true;
 }
 
 const Item* Inventory::equipped(Slot slot) const {
-    std::size_t idx = npos;
-    switch (slot) {
-        case Slot::Armor:   idx = eq_.armor; break;
-        case Slot::Helmet:  idx = eq_.helmet; break;
-        case Slot::Boots:   idx = eq_.boots; break;
-        case Slot::Belt:    idx = eq_.belt; break;
-        case Slot::Amulet:  idx = eq_.amulet; break;
-        case Slot::Ring1:   idx = eq_.ring1; break;
-        case Slot::Ring2:   idx = eq_.ring2; break;
-        case Slot::Offhand: idx = eq_.offHandShield; break;
-        case Slot::Weapon:  return nullptr;
-    }
+    if (slot == Slot::Weapon) return nullptr;
+    const std::size_t idx = eq_[slot];
     if (idx == npos || idx >= gear_.size()) return nullptr;
     return &gear_[idx];
 }
 
-game::GearBonuses Inventory::bonuses() const {
-    game::GearBonuses b{0,0.0,0.0,0.0};
-    auto addFrom = [&](const Item* g){
-        if (!g) return;
-        b.armor       += g->armorBonus;
-        b.pctDamage   += g->pctDamage();
-        b.critChance  += g->critChance();
-        b.attackSpeed += g->attackSpeed();
-    };
-    addFrom(equipped(Slot::Armor));
-    addFrom(equipped(Slot::Helmet));
-    addFrom(equipped(Slot::Boots));
-    addFrom(equipped(Slot::Belt));
-    addFrom(equipped(Slot::Amulet));
-    addFrom(equipped(Slot::Ring1));
-    addFrom(equipped(Slot::Ring2));
-    addFrom(equipped(Slot::Offhand));
-    return b;
+const WeaponColumns& Inventory::weaponColumns() const {
+    if (columnsDirty_) {
+        weaponCols_.assign(weapons_.data(), weapons_.size());
+        columnsDirty_ = false;
+    }
+    return weaponCols_;
 }
 
 bool Inventory::equipBest() {
     if (weapons_.empty()) return false;
-    game::GearBonuses b = bonuses();
-    double best = -std::numeric_limits<double>::infinity();
-    std::size_t bestIdx = 0;
-    for (std::size_t i=0;i<weapons_.size();++i) {
-        const double dpr = expectedDPR(weapons_[i], b.pctDamage, b.critChance, b.attackSpeed);
-        if (dpr > best) { best = dpr; bestIdx = i; }
+    const std::size_t bestIdx = weaponColumns().best(bonuses());
+    return bestIdx != WeaponColumns::npos && equip(bestIdx);
+}
+
+bool Inventory::applyLoadout(const Equipped& e) {
+    auto weaponOk = [&](std::size_t i){ return i == npos || i < weapons_.size(); };
+    auto gearOk = [&](Slot s) {
+        const std::size_t i = e[s];
+        if (i == npos) return true;
+        if (s == Slot::Weapon || i >= gear_.size()) return false;
+        const Slot g = gear_[i].slot;
+        const bool ring = s == Slot::Ring1 || s == Slot::Ring2;
+        return g == s || (ring && (g == Slot::Ring1 || g == Slot::Ring2));
+    };
+    if (!weaponOk(e.mainHand) || !weaponOk(e.offHandWpn)) return false;
+    // One item can't fill two places: both hands, or both ring slots.
+    if (e.mainHand != npos && e.mainHand == e.offHandWpn) return false;
+    if (e[Slot::Ring1] != npos && e[Slot::Ring1] == e[Slot::Ring2]) return false;
+    if (e.offHandWpn != npos && (e[Slot::Offhand] != npos || weapons_[e.offHandWpn].twoHanded)) return false;
+    if (e.mainHand != npos && weapons_[e.mainHand].twoHanded &&
+        (e.offHandWpn != npos || e[Slot::Offhand] != npos)) return false;
+    for (std::size_t s = 0; s < kSlotCount; ++s) {
+        if (!gearOk(static_cast<Slot>(s))) return false;
+    }
+    eq_ = e;
+    refreshBonuses();
+    return true;
+}
+
+std::uint32_t Inventory::newSlot(bool gear, std::size_t pos) {
+    std::uint32_t s;
+    if (!freeSlots_.empty()) {
+        s = freeSlots_.back();
+        freeSlots_.pop_back();
+    } else {
+        s = static_cast<std::uint32_t>(slots_.size());
+        slots_.emplace_back();
+    }
+    slots_[s].pos  = static_cast<std::uint32_t>(pos);
+    slots_[s].gear = gear;
+    return s;
+}
+
+ItemHandle Inventory::weaponHandle(std::size_t i) const {
+    const std::uint32_t s = weaponSlot_[i];
+    return ItemHandle{s, slots_[s].gen};
+}
+
+ItemHandle Inventory::gearHandle(std::size_t i) const {
+    const std::uint32_t s = gearSlot_[i];
+    return ItemHandle{s, slots_[s].gen};
+}
+
+std::size_t Inventory::indexOf(ItemHandle h) const {
+    if (h.slot >= slots_.size()) return npos;
+    const HandleSlot& s = slots_[h.slot];
+    return (s.gen == h.gen && s.pos != kFreeSlot) ? s.pos : npos;
+}
+
+const Item* Inventory::find(ItemHandle h) const {
+    const std::size_t i = indexOf(h);
+    if (i == npos) return nullptr;
+    return slots_[h.slot].gear ? &gear_[i] : &weapons_[i];
+}
+
+bool Inventory::remove(ItemHandle h) {
+    const std::size_t i = indexOf(h);
+    if (i == npos) return false;
+    if (slots_[h.slot].gear) removeGearAt(i); else removeWeaponAt(i);
+    return true;
+}
+
+// Both removals swap the last item into i, repoint its handle slot and retire
+// the removed one's; bumping the generation is what makes old handles stale.
+void Inventory::removeWeaponAt(std::size_t i) {
+    const std::size_t last = weapons_.size() - 1;
+    HandleSlot& dead = slots_[weaponSlot_[i]];
+    dead.pos = kFreeSlot;
+    ++dead.gen;
+    freeSlots_.push_back(weaponSlot_[i]);
+    if (i != last) {
+        weapons_[i]    = std::move(weapons_[last]);
+        weaponSlot_[i] = weaponSlot_[last];
+        slots_[weaponSlot_[i]].pos = static_cast<std::uint32_t>(i);
     }
-    return equip(bestIdx);
+    weapons_.pop_back();
+    weaponSlot_.pop_back();
+    if (!columnsDirty_) weaponCols_.swapRemove(i);
+
+    for (std::size_t* e : {&eq_.mainHand, &eq_.offHandWpn}) {
+        if (*e == i) *e = npos;
+        else if (*e == last) *e = i;
+    }
+}
+
+void Inventory::removeGearAt(std::size_t i) {
+    const std::size_t last = gear_.size() - 1;
+    HandleSlot& dead = slots_[gearSlot_[i]];
+    dead.pos = kFreeSlot;
+    ++dead.gen;
+    freeSlots_.push_back(gearSlot_[i]);
+    if (i != last) {
+        gear_[i]     = std::move(gear_[last]);
+        gearSlot_[i] = gearSlot_[last];
+        slots_[gearSlot_[i]].pos = static_cast<std::uint32_t>(i);
+    }
+    gear_.pop_back();
+    gearSlot_.pop_back();
+
+    // The moved piece keeps its cached bonus; only an unequip changes the sum.
+    for (std::size_t s = 0; s < kSlotCount; ++s) {
+        std::size_t& e = eq_.gear[s];
+        if (e == i) setGear(static_cast<Slot>(s), npos);
+        else if (e == last) e = i;
+    }
+}
+
+bool Inventory::gearEquipped(std::size_t i) const {
+    return std::find(eq_.gear.begin(), eq_.gear.end(), i) != eq_.gear.end();
+}
+
+// Walking down from the end, each swap-remove only moves an item that was
+// already checked, so one pass visits everything once.
+std::size_t Inventory::salvageBelow(Rarity r) {
+    const std::size_t before = weapons_.size() + gear_.size();
+    for (std::size_t i = weapons_.size(); i-- > 0;) {
+        if (weapons_[i].rarity < r && i != eq_.mainHand && i != eq_.offHandWpn) removeWeaponAt(i);
+    }
+    for (std::size_t i = gear_.size(); i-- > 0;) {
+        if (gear_[i].rarity < r && !gearEquipped(i)) removeGearAt(i);
+    }
+    return before - weapons_.size() - gear_.size();
+}
+
+std::size_t Inventory::salvageWeaponsBelow(double minDPR) {
+    const std::size_t before = weapons_.size();
+    std::vector<double> dpr(before);
+    weaponColumns().dpr(bonuses(), dpr.data());
+    for (std::size_t i = before; i-- > 0;) {
+        if (dpr[i] < minDPR && i != eq_.mainHand && i != eq_.offHandWpn) removeWeaponAt(i);
+    }
+    return before - weapons_.size();
+}
+
+std::vector<std::size_t> Inventory::topWeapons(std::size_t k) const {
+    return weaponColumns().topK(bonuses(), k);
 }
 
 } // namespace game
\ No newline at end of file
@@ -0,0 +1,293 @@
+#include "game/loadout.hpp"
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <vector>
+
+namespace game {
+
+namespace {
+
+constexpr std::size_t npos = Inventory::npos;
+
+struct Bonus {
+    double armor = 0.0, pct = 0.0, crit = 0.0, as = 0.0;
+};
+
+Bonus operator+(const Bonus& a, const Bonus& b) {
+    return Bonus{a.armor + b.armor, a.pct + b.pct, a.crit + b.crit, a.as + b.as};
+}
+
+Bonus maxOf(const Bonus& a, const Bonus& b) {
+    return Bonus{std::max(a.armor, b.armor), std::max(a.pct, b.pct),
+                 std::max(a.crit, b.crit),   std::max(a.as, b.as)};
+}
+
+// Stats the objective gives no weight are left at zero, so they don't keep
+// otherwise dominated pieces on the fronts.
+Bonus gearBonus(const Item& g, const LoadoutObjective& obj) {
+    const bool dpr = obj.dprWeight != 0.0;
+    return Bonus{obj.armorWeight != 0.0 ? static_cast<double>(g.armorBonus) : 0.0,
+                 dpr ? g.pctDamage() : 0.0, dpr ? g.critChance() : 0.0, dpr ? g.attackSpeed() : 0.0};
+}
+
+// One choice for a slot: a gear piece, an off-hand weapon, or nothing.
+struct Option {
+    std::size_t idx = npos;
+    bool weapon = false;   // idx is a weapon index (off-hand slot only)
+    Bonus b;
+};
+
+// Inputs of expectedDamagePerSwing(), used to bound an undecided off-hand.
+struct SwingStats {
+    double avg = 0.0, pct = 0.0, crit = 0.0, critMult = 1.0;
+};
+
+double swingDamage(const SwingStats& s, double extraPct, double extraCrit) {
+    const double scaled = s.avg * (1.0 + s.pct + extraPct);
+    const double critC  = std::clamp(s.crit + extraCrit, 0.0, 0.95);
+    return scaled * (1.0 + critC * (s.critMult - 1.0));
+}
+
+SwingStats swingStats(const Item& w) {
+    return SwingStats{(w.minDmg() + w.maxDmg()) / 2.0, w.pctDamage(), w.critChance(), w.critMult()};
+}
+
+// Keeps the elements dominated (>= in every dimension) by fewer than `keep`
+// others; identical vectors count the lower-index element as dominating.
+// Sorting lexicographically descending puts every dominator first, so each
+// element only needs checking against the ones kept so far.
+template<std::size_t K, typename T, typename Dims>
+std::vector<T> paretoFilter(std::vector<T> items, std::size_t keep, Dims dims) {
+    using Vec = std::array<double, K>;
+    std::vector<std::pair<Vec, T>> rows;
+    rows.reserve(items.size());
+    for (auto& t : items) rows.emplace_back(dims(t), std::move(t));
+    std::stable_sort(rows.begin(), rows.end(),
+                     [](const auto& a, const auto& b){ return a.first > b.first; });
+
+    auto geq = [](const Vec& a, const Vec& b) {
+        for (std::size_t k = 0; k < K; ++k) if (a[k] < b[k]) return false;
+        return true;
+    };
+
+    std::vector<Vec> keptDims;
+    std::vector<T>   kept;
+    std::size_t lastHit = 0;   // neighbours tend to share a dominator
+    for (auto& row : rows) {
+        std::size_t dominatedBy = 0;
+        if (keep == 1 && lastHit < keptDims.size() && geq(keptDims[lastHit], row.first)) continue;
+        for (std::size_t i = 0; i < keptDims.size(); ++i) {
+            if (geq(keptDims[i], row.first) && ++dominatedBy >= keep) { lastHit = i; break; }
+        }
+        if (dominatedBy < keep) {
+            keptDims.push_back(row.first);
+            kept.push_back(std::move(row.second));
+        }
+    }
+    return kept;
+}
+
+
+std::array<double, 4> bonusDims(const Bonus& b) { return {b.armor, b.pct, b.crit, b.as}; }
+
+// Gear options for one slot (or the ring pool), with "empty" as a candidate.
+std::vector<Option> gearFront(const Inventory& inv, const LoadoutObjective& obj, bool (*fits)(Slot),
+                              std::size_t keep) {
+    std::vector<Option> opts{Option{}};
+    for (std::size_t i = 0; i < inv.gearCount(); ++i) {
+        const Item& g = inv.gearAt(i);
+        if (fits(g.slot)) opts.push_back(Option{i, false, gearBonus(g, obj)});
+    }
+    return paretoFilter<4>(std::move(opts), keep, [](const Option& o){ return bonusDims(o.b); });
+}
+
+// Summed bonus of several slots plus the gear index picked for each.
+struct Combo {
+    Bonus b;
+    std::array<std::size_t, 4> pick{npos, npos, npos, npos};
+};
+
+std::vector<Combo> paretoCombos(std::vector<Combo> v) {
+    return paretoFilter<4>(std::move(v), 1, [](const Combo& c){ return bonusDims(c.b); });
+}
+
+// Every combo of `acc` with every option of one more slot, stored at pick[pos].
+std::vector<Combo> extend(const std::vector<Combo>& acc, const std::vector<Option>& opts, std::size_t pos) {
+    std::vector<Combo> out;
+    out.reserve(acc.size() * opts.size());
+    for (const auto& c : acc) {
+        for (const auto& o : opts) {
+            Combo n = c;
+            n.b = c.b + o.b;
+            n.pick[pos] = o.idx;
+            out.push_back(n);
+        }
+    }
+    return paretoCombos(std::move(out));
+}
+
+// Ring1/Ring2 fillings: none, one ring, or two distinct rings.
+std::vector<Combo> ringPairs(const std::vector<Option>& rings, std::size_t pos) {
+    std::vector<Combo> out{Combo{}};
+    for (std::size_t i = 0; i < rings.size(); ++i) {
+        Combo one;
+        one.b = rings[i].b;
+        one.pick[pos] = rings[i].idx;
+        out.push_back(one);
+        for (std::size_t j = i + 1; j < rings.size(); ++j) {
+            Combo two = one;
+            two.b = one.b + rings[j].b;
+            two.pick[pos + 1] = rings[j].idx;
+            out.push_back(two);
+        }
+    }
+    return paretoCombos(std::move(out));
+}
+
+Bonus maxBonus(const std::vector<Combo>& v) {
+    Bonus m;
+    for (const auto& c : v) m = maxOf(m, c.b);
+    return m;
+}
+
+// Objective for one main hand + off-hand choice. Non-decreasing in every
+// bonus stat, which is what makes the sums of per-stat maxima valid bounds.
+struct Scorer {
+    const LoadoutObjective& obj;
+    const Item* main;
+    const SwingStats* offWpn;
+
+    double operator()(const Bonus& g) const {
+        double dpr = main ? expectedDPR(*main, g.pct, g.crit, g.as) : 0.0;
+        if (offWpn) dpr += swingDamage(*offWpn, g.pct, g.crit);
+        return obj.dprWeight * dpr + obj.armorWeight * g.armor;
+    }
+};
+
+// A full gear set: one combo from each half and their summed bonus.
+struct GearSet {
+    Bonus b;
+    const Combo* left;
+    const Combo* right;
+};
+
+// The Pareto front of every left + right sum. It doesn't depend on the
+// weapons, so it is built once and each hand pair only scans it.
+std::vector<GearSet> join(const std::vector<Combo>& left, const std::vector<Combo>& right) {
+    std::vector<GearSet> out;
+    out.reserve(left.size() * right.size());
+    for (const auto& l : left) {
+        for (const auto& r : right) out.push_back(GearSet{l.b + r.b, &l, &r});
+    }
+    return paretoFilter<4>(std::move(out), 1, [](const GearSet& g){ return bonusDims(g.b); });
+}
+
+} // namespace
+
+LoadoutResult optimizeLoadout(const Inventory& inv, const LoadoutObjective& obj) {
+    // Per-slot fronts. Rings fill a pair and off-hand weapons may collide with
+    // the main hand, so those keep everything dominated by fewer than two.
+    std::vector<Option> armor   = gearFront(inv, obj, [](Slot s){ return s == Slot::Armor;  }, 1);
+    std::vector<Option> helmet  = gearFront(inv, obj, [](Slot s){ return s == Slot::Helmet; }, 1);
+    std::vector<Option> boots   = gearFront(inv, obj, [](Slot s){ return s == Slot::Boots;  }, 1);
+    std::vector<Option> belt    = gearFront(inv, obj, [](Slot s){ return s == Slot::Belt;   }, 1);
+    std::vector<Option> amulet  = gearFront(inv, obj, [](Slot s){ return s == Slot::Amulet; }, 1);
+    std::vector<Option> shields = gearFront(inv, obj, [](Slot s){ return s == Slot::Offhand; }, 1);
+    std::vector<Option> rings   = gearFront(inv, obj, [](Slot s){ return s == Slot::Ring1 || s == Slot::Ring2; }, 2);
+    rings.erase(std::remove_if(rings.begin(), rings.end(), [](const Option& o){ return o.idx == npos; }), rings.end());
+
+    // Meet in the middle: body slots on one side, jewellery and belt on the
+    // other, each reduced to its own Pareto front of summed bonuses.
+    const std::vector<Combo> left  = extend(extend(extend({Combo{}}, armor, 0), helmet, 1), boots, 2);
+    const std::vector<Combo> right = extend(extend(ringPairs(rings, 2), belt, 0), amulet, 1);
+    const std::vector<GearSet> sets = join(left, right);
+    const Bonus setMax = maxBonus(left) + maxBonus(right);
+
+    std::vector<std::size_t> weaponIdx(inv.weaponsCount());
+    for (std::size_t i = 0; i < weaponIdx.size(); ++i) weaponIdx[i] = i;
+    auto weaponDims = [&](std::size_t i) {
+        const Item& w = inv.weaponAt(i);
+        const SwingStats s = swingStats(w);
+        return std::array<double, 6>{w.twoHanded ? 0.0 : 1.0, s.avg, s.pct, s.crit, s.critMult, w.attackSpeed()};
+    };
+    std::vector<std::size_t> mains = paretoFilter<6>(weaponIdx, 2, weaponDims);
+    if (mains.empty()) mains.push_back(npos);
+
+    std::vector<std::size_t> oneHanded;
+    for (std::size_t i : weaponIdx) if (!inv.weaponAt(i).twoHanded) oneHanded.push_back(i);
+    const std::vector<std::size_t> offWeapons = paretoFilter<4>(oneHanded, 2, [&](std::size_t i){
+        const SwingStats s = swingStats(inv.weaponAt(i));
+        return std::array<double, 4>{s.avg, s.pct, s.crit, s.critMult};
+    });
+
+    std::vector<Option> offhand{Option{}};   // [0] = empty, the only choice behind a 2H
+    for (const auto& o : shields) if (o.idx != npos) offhand.push_back(o);
+    std::vector<SwingStats> offStats(offhand.size());
+    for (std::size_t i : offWeapons) {
+        offhand.push_back(Option{i, true, Bonus{}});
+        offStats.push_back(swingStats(inv.weaponAt(i)));
+    }
+
+    // Every main hand / off-hand pair with its optimistic score, best first,
+    // so the search stops at the first pair the incumbent already beats.
+    struct Pair { double bound; std::size_t main, off; };
+    std::vector<Pair> order;
+    for (std::size_t m : mains) {
+        const Item* w = (m == npos) ? nullptr : &inv.weaponAt(m);
+        const std::size_t ohCount = (!w || !w->twoHanded) ? offhand.size() : 1;
+        for (std::size_t k = 0; k < ohCount; ++k) {
+            const Option& oh = offhand[k];
+            if (oh.weapon && oh.idx == m) continue;
+            const Scorer F{obj, w, oh.weapon ? &offStats[k] : nullptr};
+            order.push_back(Pair{F(oh.b + setMax), m, k});
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [](const Pair& a, const Pair& b){ return a.bound > b.bound; });
+
+    double best = -std::numeric_limits<double>::infinity();
+    Inventory::Equipped bestEq;
+    for (const Pair& p : order) {
+        if (p.bound <= best) break;
+        const Item* w = (p.main == npos) ? nullptr : &inv.weaponAt(p.main);
+        const Option& oh = offhand[p.off];
+        const Scorer F{obj, w, oh.weapon ? &offStats[p.off] : nullptr};
+
+        const GearSet* pick = nullptr;
+        for (const auto& g : sets) {
+            const double s = F(oh.b + g.b);
+            if (s > best) { best = s; pick = &g; }
+        }
+        if (!pick) continue;
+        bestEq = Inventory::Equipped{};
+        bestEq.mainHand = p.main;
+        if (oh.weapon) bestEq.offHandWpn = oh.idx; else bestEq[Slot::Offhand] = oh.idx;
+        bestEq[Slot::Armor]  = pick->left->pick[0];
+        bestEq[Slot::Helmet] = pick->left->pick[1];
+        bestEq[Slot::Boots]  = pick->left->pick[2];
+        bestEq[Slot::Belt]   = pick->right->pick[0];
+        bestEq[Slot::Amulet] = pick->right->pick[1];
+        bestEq[Slot::Ring1]  = pick->right->pick[2];
+        bestEq[Slot::Ring2]  = pick->right->pick[3];
+    }
+
+    LoadoutResult r;
+    r.eq = bestEq;
+    auto addGear = [&](std::size_t i) {
+        if (i == npos) return;
+        const Item& g = inv.gearAt(i);
+        r.bonuses.armor       += g.armorBonus;
+        r.bonuses.pctDamage   += g.pctDamage();
+        r.bonuses.critChance  += g.critChance();
+        r.bonuses.attackSpeed += g.attackSpeed();
+    };
+    for (Slot s : {Slot::Armor, Slot::Helmet, Slot::Boots, Slot::Belt, Slot::Amulet,
+                   Slot::Ring1, Slot::Ring2, Slot::Offhand}) addGear(r.eq[s]);
+    const GearBonuses& b = r.bonuses;
+    if (r.eq.mainHand != npos)   r.dpr += expectedDPR(inv.weaponAt(r.eq.mainHand), b.pctDamage, b.critChance, b.attackSpeed);
+    if (r.eq.offHandWpn != npos) r.dpr += expectedDamagePerSwing(inv.weaponAt(r.eq.offHandWpn), b.pctDamage, b.critChance);
+    r.score = obj.dprWeight * r.dpr + obj.armorWeight * b.armor;
+    return r;
+}
+
+} // namespace game
@@ -1,4 +1,6 @@
 #include "game/loot_tables.hpp"
+#include "game/content_pack.hpp"
+#include "game/default_loot.hpp"
 #include "game/item.hpp"
 #include <algorithm>
 
@@ -6,19 +8,7 @@ namespace game {
 
 static int clampi(int v, int a, int b){ return v < a ? a : (v > b ? b : v); }
 
-Item LootTables::rollWeapon(core::RNG& rng, int /*level*/) const {
-    Rarity r = rarity.pick(rng);
-    WeaponBase wb = bases.pick(rng);
-
-    Item w;
-    w.name    = wb.name;
-    w.rarity  = r;
-    w.kind    = ItemKind::Weapon;
-    w.slot    = Slot::Weapon;
-    w.baseMin = wb.baseMin;
-    w.baseMax = wb.baseMax;
-
-    int preCount = 0, sufCount = 0;
+static void affixCounts(Rarity r, int& preCount, int& sufCount) {
     switch (r) {
         case Rarity::Common:    preCount=0; sufCount=0; break;
         case Rarity::Magic:     preCount=1; sufCount=0; break;
@@ -26,116 +16,220 @@ Item LootTables::rollWeapon(core::RNG& rng, int /*level*/) const {
         case Rarity::Epic:      preCount=2; sufCount=1; break;
         case Rarity::Legendary: preCount=2; sufCount=2; break;
     }
+}
 
-    auto pickAffix = [&](const std::vector<Affix>& pool){
-        return pool.empty() ? Affix{} : pool[ static_cast<size_t>(rng.i(0, static_cast<int>(pool.size()) - 1)) ];
-    };
+static void rollAffixes(const LootTables& lt, core::RNG& rng, int level, Rarity r, AffixList& out) {
+    int preCount = 0, sufCount = 0;
+    affixCounts(r, preCount, sufCount);
 
-    for (int i = 0; i < preCount && !prefixes.empty(); ++i) w.affixes.push_back(pickAffix(prefixes));
-    for (int i = 0; i < sufCount && !suffixes.empty(); ++i) w.affixes.push_back(pickAffix(suffixes));
+    out.clear();
+    lt.prefixes.roll(rng, level, preCount, out);
+    lt.suffixes.roll(rng, level, sufCount, out);
+}
 
-    return w;
+// The base tables live in one of three places: the in-memory WeightedTables,
+// a mapped ContentPack or the constexpr defaults. Each source yields the same
+// fields, so the item-filling code below is shared.
+struct BaseDraw {
+    std::string_view name;
+    Slot slot;
+    int  lo, hi;   // damage range for weapons, armor range for gear
+};
+
+struct TableSource {
+    const LootTables& lt;
+    bool isGear(core::RNG& rng) const { return !lt.dropType.empty() && lt.dropType.pick(rng) == 1; }
+    Rarity rarity(core::RNG& rng) const { return lt.rarity.pick(rng); }
+    BaseDraw weapon(core::RNG& rng) const {
+        const WeaponBase& b = lt.bases.pick(rng);
+        return BaseDraw{b.name, Slot::Weapon, b.baseMin, b.baseMax};
+    }
+    BaseDraw gear(core::RNG& rng) const {
+        const GearBase& b = lt.gearBases.pick(rng);
+        return BaseDraw{b.name, b.slot, b.armorMin, b.armorMax};
+    }
+};
+
+struct PackSource {
+    const ContentPack& p;
+    bool isGear(core::RNG& rng) const { return p.header().dropType.count != 0 && p.pickDropType(rng) == 1; }
+    Rarity rarity(core::RNG& rng) const { return p.pickRarity(rng); }
+    BaseDraw weapon(core::RNG& rng) const {
+        const PackWeaponBase& b = p.pickWeaponBase(rng);
+        return BaseDraw{p.str(b.name), Slot::Weapon, b.baseMin, b.baseMax};
+    }
+    BaseDraw gear(core::RNG& rng) const {
+        const PackGearBase& b = p.pickGearBase(rng);
+        return BaseDraw{p.str(b.name), static_cast<Slot>(b.slot), b.armorMin, b.armorMax};
+    }
+};
+
+struct BuiltinSource {
+    bool isGear(core::RNG& rng) const { return default_loot::kDropType.pick(rng) == 1; }
+    Rarity rarity(core::RNG& rng) const { return default_loot::kRarity.pick(rng); }
+    BaseDraw weapon(core::RNG& rng) const {
+        const default_loot::WeaponBaseDef& b = default_loot::kWeaponBases.pick(rng);
+        return BaseDraw{b.name, Slot::Weapon, b.baseMin, b.baseMax};
+    }
+    BaseDraw gear(core::RNG& rng) const {
+        const default_loot::GearBaseDef& b = default_loot::kGearBases.pick(rng);
+        return BaseDraw{b.name, b.slot, b.armorMin, b.armorMax};
+    }
+};
+
+template<typename Source>
+static void fillWeapon(const Source& src, const LootTables& lt, core::RNG& rng, int level, Item& w) {
+    const Rarity r = src.rarity(rng);
+    const BaseDraw b = src.weapon(rng);
+
+    w.name.assign(b.name.data(), b.name.size());   // reuses existing capacity
+    w.rarity     = r;
+    w.kind       = ItemKind::Weapon;
+    w.slot       = Slot::Weapon;
+    w.baseMin    = b.lo;
+    w.baseMax    = b.hi;
+    w.twoHanded  = false;
+    w.armorBonus = 0;
+    w.armorType  = ArmorType::None;
+
+    rollAffixes(lt, rng, level, r, w.affixes);
 }
 
-Item LootTables::rollGear(core::RNG& rng, int /*level*/) const {
-    Rarity r = rarity.pick(rng);
-    GearBase gb = gearBases.pick(rng);
+template<typename Source>
+static void fillGear(const Source& src, const LootTables& lt, core::RNG& rng, int level, Item& g) {
+    const Rarity r = src.rarity(rng);
+    const BaseDraw b = src.gear(rng);
 
-    Item g;
-    g.name        = gb.name;
+    g.name.assign(b.name.data(), b.name.size());
     g.rarity      = r;
     g.kind        = ItemKind::Gear;
-    g.slot        = gb.slot;
-    g.armorBonus  = clampi(rng.i(gb.armorMin, gb.armorMax), 0, 999);
+    g.slot        = b.slot;
+    g.baseMin     = 0;
+    g.baseMax     = 0;
+    g.twoHanded   = false;
+    g.armorBonus  = clampi(rng.i(b.lo, b.hi), 0, 999);
+    g.armorType   = ArmorType::None;
 
     // naive type by armor amount (tweak as you like)
     if (g.slot == Slot::Armor || g.slot == Slot::Helmet || g.slot == Slot::Boots || g.slot == Slot::Belt) {
         g.armorType = (g.armorBonus >= 3 ? ArmorType::Heavy : (g.armorBonus >= 1 ? ArmorType::Medium : ArmorType::Light));
     }
 
-    int preCount = 0, sufCount = 0;
-    switch (r) {
-        case Rarity::Common:    preCount=0; sufCount=0; break;
-        case Rarity::Magic:     preCount=1; sufCount=0; break;
-        case Rarity::Rare:      preCount=1; sufCount=1; break;
-        case Rarity::Epic:      preCount=2; sufCount=1; break;
-        case Rarity::Legendary: preCount=2; sufCount=2; break;
+    rollAffixes(lt, rng, level, r, g.affixes);
+}
+
+Item LootTables::rollWeapon(core::RNG& rng, int level) const {
+    Item w;
+    rollWeaponInto(rng, level, w);
+    return w;
+}
+
+Item LootTables::rollGear(core::RNG& rng, int level) const {
+    Item g;
+    rollGearInto(rng, level, g);
+    return g;
+}
+
+void LootTables::rollWeaponInto(core::RNG& rng, int level, Item& w) const {
+    if (pack)         fillWeapon(PackSource{*pack}, *this, rng, level, w);
+    else if (builtin) fillWeapon(BuiltinSource{}, *this, rng, level, w);
+    else              fillWeapon(TableSource{*this}, *this, rng, level, w);
+}
+
+void LootTables::rollGearInto(core::RNG& rng, int level, Item& g) const {
+    if (pack)         fillGear(PackSource{*pack}, *this, rng, level, g);
+    else if (builtin) fillGear(BuiltinSource{}, *this, rng, level, g);
+    else              fillGear(TableSource{*this}, *this, rng, level, g);
+}
+
+void LootTables::rollWeapons(core::RNG& rng, int level, Item* out, std::size_t count) const {
+    for (std::size_t k = 0; k < count; ++k) rollWeaponInto(rng, level, out[k]);
+}
+
+void LootTables::rollGears(core::RNG& rng, int level, Item* out, std::size_t count) const {
+    for (std::size_t k = 0; k < count; ++k) rollGearInto(rng, level, out[k]);
+}
+
+void LootTables::rollDrops(core::RNG& rng, int level, Item* out, std::size_t count) const {
+    for (std::size_t k = 0; k < count; ++k) {
+        if (rollIsGear(rng)) rollGearInto(rng, level, out[k]);
+        else                 rollWeaponInto(rng, level, out[k]);
     }
+}
 
-    auto pickAffix = [&](const std::vector<Affix>& pool){
-        return pool.empty() ? Affix{} : pool[ static_cast<size_t>(rng.i(0, static_cast<int>(pool.size()) - 1)) ];
-    };
+static void addDefaultTables(LootTables& lt) {
+    for (const auto& e : default_loot::kDropTypeEntries) lt.dropType.add(e.item, e.weight);
+    for (const auto& e : default_loot::kRarityEntries)   lt.rarity.add(e.item, e.weight);
+    for (const auto& e : default_loot::kWeaponBaseEntries) {
+        lt.bases.add(WeaponBase{std::string(e.item.name), e.item.baseMin, e.item.baseMax}, e.weight);
+    }
+    for (const auto& e : default_loot::kGearBaseEntries) {
+        lt.gearBases.add(GearBase{e.item.slot, std::string(e.item.name), e.item.armorMin, e.item.armorMax}, e.weight);
+    }
+}
 
-    for (int i = 0; i < preCount && !prefixes.empty(); ++i) g.affixes.push_back(pickAffix(prefixes));
-    for (int i = 0; i < sufCount && !suffixes.empty(); ++i) g.affixes.push_back(pickAffix(suffixes));
+// `table` becomes `defaults` followed by the entries it already had.
+template<typename T>
+static void appendTo(core::WeightedTable<T>& defaults, core::WeightedTable<T>& table) {
+    for (std::size_t i = 0; i < table.size(); ++i) defaults.add(table.items()[i], table.weights()[i]);
+    table = std::move(defaults);
+}
 
-    return g;
+void LootTables::build() {
+    // Rolls never read the tables while builtin is set, so edits made on top
+    // of makeDefaultLoot() switch it off: every table then holds the default
+    // entries followed by whatever was added.
+    if (builtin && !(dropType.empty() && rarity.empty() && bases.empty() && gearBases.empty())) {
+        LootTables d;
+        addDefaultTables(d);
+        appendTo(d.dropType, dropType);
+        appendTo(d.rarity, rarity);
+        appendTo(d.bases, bases);
+        appendTo(d.gearBases, gearBases);
+        builtin = false;
+    }
+    dropType.build();
+    rarity.build();
+    bases.build();
+    gearBases.build();
+    prefixes.build();
+    suffixes.build();
 }
 
 bool LootTables::rollIsGear(core::RNG& rng) const {
-    if (dropType.empty()) return false;
-    return dropType.pick(rng) == 1;
+    if (pack)    return PackSource{*pack}.isGear(rng);
+    if (builtin) return BuiltinSource{}.isGear(rng);
+    return TableSource{*this}.isGear(rng);
+}
+
+// Affix ids are only known once interned, so the pools are always built at
+// run time.
+static void addDefaultAffixes(LootTables& lt) {
+    for (const auto& t : default_loot::kPrefixes) {
+        lt.prefixes.add(internAffix(Affix::Prefix(std::string(t.name), t.flatMin, t.flatMax,
+                                                  t.pctDamage, t.critChance, t.attackSpeed)),
+                        t.weight, t.minLevel, t.maxLevel);
+    }
+    for (const auto& t : default_loot::kSuffixes) {
+        lt.suffixes.add(internAffix(Affix::Suffix(std::string(t.name), t.flatMin, t.flatMax,
+                                                  t.pctDamage, t.critChance, t.attackSpeed)),
+                        t.weight, t.minLevel, t.maxLevel);
+    }
 }
 
 LootTables makeDefaultLoot() {
     LootTables lt;
+    lt.builtin = true;
+    addDefaultAffixes(lt);
+    lt.build();
+    return lt;
+}
 
-    // Drop kind weights
-    lt.dropType.add(0, 70); // weapon
-    lt.dropType.add(1, 30); // gear
-
-    // Rarity weights
-    lt.rarity.add(Rarity::Common,    60);
-    lt.rarity.add(Rarity::Magic,     25);
-    lt.rarity.add(Rarity::Rare,      10);
-    lt.rarity.add(Rarity::Epic,       4);
-    lt.rarity.add(Rarity::Legendary,  1);
-
-    // Base weapons
-    lt.bases.add(WeaponBase{"Shortsword", 3, 7},  25);
-    lt.bases.add(WeaponBase{"Longsword",  5, 11}, 25);
-    lt.bases.add(WeaponBase{"Axe",        6, 13}, 20);
-    lt.bases.add(WeaponBase{"Mace",       7, 12}, 15);
-    lt.bases.add(WeaponBase{"Spear",      4, 10}, 15);
-
-    // Base gear
-    lt.gearBases.add(GearBase{Slot::Offhand, "Wooden Shield", 1, 3}, 18);
-    lt.gearBases.add(GearBase{Slot::Offhand, "Bronze Shield", 2, 5}, 12);
-
-    lt.gearBases.add(GearBase{Slot::Armor, "Leather Armor", 2, 5}, 22);
-    lt.gearBases.add(GearBase{Slot::Armor, "Chainmail",     3, 7}, 12);
-
-    lt.gearBases.add(GearBase{Slot::Helmet, "Cloth Hood",   0, 2}, 18);
-    lt.gearBases.add(GearBase{Slot::Helmet, "Iron Helm",    1, 3}, 12);
-
-    lt.gearBases.add(GearBase{Slot::Boots, "Traveler's Boots", 0, 2}, 20);
-    lt.gearBases.add(GearBase{Slot::Boots, "Greaves",          1, 3}, 10);
-
-    lt.gearBases.add(GearBase{Slot::Belt, "Rope Belt", 0, 0}, 16);
-    lt.gearBases.add(GearBase{Slot::Belt, "Studded Belt", 0, 1}, 10);
-
-    lt.gearBases.add(GearBase{Slot::Amulet, "Amulet", 0, 0}, 18);
-    lt.gearBases.add(GearBase{Slot::Ring1, "Copper Ring", 0, 0}, 18);
-    lt.gearBases.add(GearBase{Slot::Ring1, "Silver Ring", 0, 0}, 12);
-
-    // Prefixes
-    lt.prefixes = {
-        Affix::Prefix("Jagged",     1, 2,  0.00, 0.00, 0.00),
-        Affix::Prefix("Heavy",      2, 4,  0.10, 0.00, -0.05),
-        Affix::Prefix("Keen",       0, 0,  0.00, 0.05, 0.00),
-        Affix::Prefix("Swift",      0, 0,  0.00, 0.00, 0.15),
-        Affix::Prefix("Brutal",     2, 3,  0.20, 0.02, -0.05),
-    };
-
-    // Suffixes
-    lt.suffixes = {
-        Affix::Suffix("of Embers",  0, 0,  0.12, 0.00, 0.00),
-        Affix::Suffix("of Frost",   0, 0,  0.10, 0.02, 0.00),
-        Affix::Suffix("of Haste",   0, 0,  0.00, 0.00, 0.20),
-        Affix::Suffix("of Slaying", 1, 2,  0.08, 0.03, 0.00),
-        Affix::Suffix("of Mauling", 3, 3,  0.00, 0.00, -0.05),
-    };
-
+LootTables makeEditableDefaultLoot() {
+    LootTables lt;
+    addDefaultTables(lt);
+    addDefaultAffixes(lt);
+    lt.build();
     return lt;
 }
 
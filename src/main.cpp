@@ -1,3 +1,4 @@
+#include <string>
 #include <vector>
 #include "core/rng.hpp"
 #include "game/loot_tables.hpp"
@@ -6,22 +7,26 @@
 
 using namespace game;
 
+static Item mkWeapon(const std::string& name, int mn, int mx) {
+    Item w; w.name=name; w.kind=ItemKind::Weapon; w.slot=Slot::Weapon; w.baseMin=mn; w.baseMax=mx; return w;
+}
+
 int main() {
     core::RNG rng(1337);
     LootTables loot = makeDefaultLoot();
 
     // Inventory + starter
     Inventory inv;
-    std::size_t starterIdx = inv.add(Weapon{ WeaponBase{"Rusty Sword", 2, 6}, Rarity::Common, {} });
+    std::size_t starterIdx = inv.addWeapon(mkWeapon("Rusty Sword", 2, 6));
     inv.equip(starterIdx);
 
     // Player uses equipped item
     Actor player{ "Player", 60, 60, 1, *inv.equipped() };
 
     // Enemies
-    Weapon goblinW{ WeaponBase{"Shiv",   1, 4}, Rarity::Common, {} };
-    Weapon bruteW { WeaponBase{"Club",   3, 7}, Rarity::Common, {} };
-    Weapon raiderW{ WeaponBase{"Hatchet",2, 6}, Rarity::Common, {} };
+    Item goblinW = mkWeapon("Shiv",    1, 4);
+    Item bruteW  = mkWeapon("Club",    3, 7);
+    Item raiderW = mkWeapon("Hatchet", 2, 6);
 
     std::vector<Actor> pack = {
         Actor{"Goblin", 20, 20, 0, goblinW},
@@ -1,21 +1,19 @@
 #include <algorithm>
 #include <cctype>
-#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
-#include <limits>
 #include <sstream>
 #include <string>
 #include <vector>
 
-#include "core/rng.hpp"
-#include "game/rarity.hpp"
-#include "game/weapon.hpp"
-#include "game/weapon_base.hpp"
-#include "game/affix.hpp"
 #include "game/actor.hpp"
 #include "game/inventory.hpp"
-#include "game/loot_tables.hpp"
 #include "game/combat_math.hpp"
+#include "game/combat_event.hpp"
+#include "game/replay.hpp"
+#include "game/session.hpp"
 
 using namespace game;
 
@@ -32,9 +30,18 @@ static void print_help() {
     "  b / best              - equip best-by-DPR item\n"
     "  a / auto              - toggle auto-equip-on-drop\n"
     "  r / reset             - reset battle (keeps inventory)\n"
+    "  s / salvage <rarity>  - remove unequipped items below rarity (e.g. Rare)\n"
+    "  autosalvage <rarity>  - salvage below rarity on every reset (Common = off)\n"
     "  x / exit              - quit\n";
 }
 
+static void print_usage() {
+    std::cout <<
+    "Usage: oathbound_cli [options]\n"
+    "  --seed <n>         RNG seed (default 1337)\n"
+    "  --record <file>    write a replay of the session on exit\n";
+}
+
 static void print_player(const Actor& player) {
     std::cout << "Player HP: " << player.hp << "/" << player.maxHP
               << "  Armor: " << player.armor << "\n"
@@ -56,10 +63,10 @@ static void print_enemies(const std::vector<Actor>& enemies, int selected) {
 }
 
 static void print_inventory(const Inventory& inv) {
-    std::cout << "Inventory (" << inv.size() << " items):\n";
-    for (size_t i = 0; i < inv.size(); ++i) {
-        const auto& w = inv.at(i);
-        const bool eq = (inv.equippedIndex() == i);
+    std::cout << "Inventory (" << inv.weaponsCount() << " items):\n";
+    for (size_t i = 0; i < inv.weaponsCount(); ++i) {
+        const auto& w = inv.weaponAt(i);
+        const bool eq = (inv.loadout().mainHand == i);
         std::cout << "  [" << (i < 10 ? "0" : "") << i << "] "
                   << (eq ? "* " : "  ")
                   << w.label()
@@ -67,94 +74,38 @@ static void print_inventory(const Inventory& inv) {
     }
 }
 
-static std::vector<Actor> make_enemies() {
-    Weapon goblinW{ WeaponBase{"Shiv",   1, 4}, Rarity::Common, {} };
-    Weapon bruteW { WeaponBase{"Club",   3, 7}, Rarity::Common, {} };
-    Weapon raiderW{ WeaponBase{"Hatchet",2, 6}, Rarity::Common, {} };
-    return {
-        Actor{"Goblin", 20, 20, 0, goblinW},
-        Actor{"Brute",  35, 35, 1, bruteW },
-        Actor{"Raider", 25, 25, 0, raiderW}
-    };
-}
-
-int main() {
-    // ---- Game state
-    core::RNG rng(1337);
-    LootTables loot = makeDefaultLoot();
-
-    Inventory inv;
-    size_t starterIdx = inv.add(Weapon{ WeaponBase{"Rusty Sword", 2, 6}, Rarity::Common, {} });
-    inv.equip(starterIdx);
-
-    Actor player{ "Player", 60, 60, 1, *inv.equipped() };
-    std::vector<Actor> enemies = make_enemies();
-    int selectedEnemy = 0;
-    bool autoEquipBetter = true;
-
-    auto any_alive = [&](){ for (auto& e: enemies) if (e.alive()) return true; return false; };
-
-    auto reset_battle = [&](){
-        player = Actor{ "Player", 60, 60, 1, *inv.equipped() };
-        enemies = make_enemies();
-        selectedEnemy = 0;
-        std::cout << "Battle reset.\n";
-    };
+int main(int argc, char** argv) {
+    std::uint64_t seed = Session::kDefaultSeed;
+    std::string recordPath;
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        const bool hasVal = i + 1 < argc;
+        if      (!std::strcmp(a, "--seed") && hasVal)   seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(a, "--record") && hasVal) recordPath = argv[++i];
+        else { print_usage(); return 1; }
+    }
 
-    auto do_player_turn = [&](){
-        // Choose target: preferred selectedEnemy if alive; else first alive.
-        auto it = enemies.end();
-        if (selectedEnemy >= 0 && selectedEnemy < static_cast<int>(enemies.size()) && enemies[selectedEnemy].alive()) {
-            it = enemies.begin() + selectedEnemy;
-        } else {
-            it = std::find_if(enemies.begin(), enemies.end(), [](const Actor& e){ return e.alive(); });
-        }
-        if (it == enemies.end()) return;
-
-        Actor& target = *it;
-        int hits = std::max(1, static_cast<int>(std::round(player.weapon.attackSpeed())));
-        for (int h = 0; h < hits && target.alive(); ++h) {
-            int dmg = player.attack(target, rng);
-            target.hp -= dmg;
-            std::cout << "You hit " << target.name << " for " << dmg
-                      << "  (" << std::max(0, target.hp) << "/" << target.maxHP << ")\n";
-        }
-        if (!target.alive()) {
-            std::cout << target.name << " is slain!\n";
-            Weapon drop = loot.rollWeapon(rng, 1);
-            std::cout << "Loot dropped: " << drop.label() << "\n";
-            size_t idx = inv.add(drop);
-
-            if (autoEquipBetter) {
-                double cur = expectedDPR(player.weapon);
-                double cand = expectedDPR(inv.at(idx));
-                if (cand > cur) {
-                    inv.equip(idx);
-                    player.weapon = *inv.equipped();
-                    std::cout << "Auto-equipped better weapon (" << cand << " DPR > " << cur << " DPR).\n";
-                }
-            }
-        }
+    // ---- Game state. Combat only records events; they are formatted when a
+    // command finishes.
+    CombatEventRing events(1024);
+    Session game(seed, &events);
+    Replay replay;
+    if (!recordPath.empty()) game.record(&replay);
+
+    auto flush_events = [&](){
+        events.drain([&](const CombatEvent& e){
+            formatEvent(std::cout, e, game.roster(), &game.inventory());
+            std::cout << "\n";
+        });
     };
 
-    auto do_enemies_turn = [&](){
-        for (auto& e : enemies) {
-            if (!e.alive() || !player.alive()) continue;
-            int hits = std::max(1, static_cast<int>(std::round(e.weapon.attackSpeed())));
-            for (int h=0; h<hits && player.alive(); ++h) {
-                int dmg = e.attack(player, rng);
-                player.hp -= dmg;
-                std::cout << e.name << " hits you for " << dmg
-                          << "  (You: " << std::max(0, player.hp) << "/" << player.maxHP << ")\n";
-            }
-        }
-    };
+    auto item_count = [&](){ return game.inventory().weaponsCount() + game.inventory().gearCount(); };
 
     // ---- Intro & help
     std::cout << "Castle-like Combat (Console Prototype)\n";
     print_help();
-    print_player(player);
-    print_enemies(enemies, selectedEnemy);
+    print_player(game.player());
+    print_enemies(game.enemies(), game.selectedEnemy());
 
     // ---- Input loop
     std::string line;
@@ -170,55 +121,71 @@ int main() {
             print_help();
 
         } else if (cmd == "p" || cmd == "player") {
-            print_player(player);
+            print_player(game.player());
 
         } else if (cmd == "e" || cmd == "enemies") {
-            print_enemies(enemies, selectedEnemy);
+            print_enemies(game.enemies(), game.selectedEnemy());
 
         } else if (cmd == "t" || cmd == "target") {
             int idx = -1;
             if (!(iss >> idx)) {
                 std::cout << "Usage: target <index>\n";
-            } else if (idx < 0 || idx >= static_cast<int>(enemies.size())) {
+            } else if (!game.target(idx)) {
                 std::cout << "Invalid index. Use 'enemies' to list.\n";
             } else {
-                selectedEnemy = idx;
-                std::cout << "Target set to [" << idx << "] " << enemies[idx].name << ".\n";
+                std::cout << "Target set to [" << idx << "] " << game.enemies()[static_cast<size_t>(idx)].name << ".\n";
             }
 
         } else if (cmd == "n" || cmd == "next") {
-            if (!player.alive()) { std::cout << "You are dead. Use 'reset'.\n"; continue; }
-            if (!any_alive())    { std::cout << "No enemies alive. Use 'reset'.\n"; continue; }
-            do_player_turn();
-            do_enemies_turn();
-            if (!player.alive()) std::cout << "Defeat. You died.\n";
-            else if (!any_alive()) std::cout << "Victory! All enemies defeated.\n";
+            if (!game.next()) {
+                if (!game.player().alive()) std::cout << "You are dead. Use 'reset'.\n";
+                else                        std::cout << "No enemies alive. Use 'reset'.\n";
+            }
+            flush_events();
 
         } else if (cmd == "i" || cmd == "inventory") {
-            print_inventory(inv);
+            print_inventory(game.inventory());
 
         } else if (cmd == "q" || cmd == "equip") {
             int idx = -1;
             if (!(iss >> idx)) {
                 std::cout << "Usage: equip <index>\n";
-            } else if (idx < 0 || idx >= static_cast<int>(inv.size())) {
+            } else if (!game.equip(idx)) {
                 std::cout << "Invalid index. Use 'inventory' to list.\n";
             } else {
-                inv.equip(static_cast<size_t>(idx));
-                player.weapon = *inv.equipped();
-                std::cout << "Equipped: " << inv.at(static_cast<size_t>(idx)).label() << "\n";
+                std::cout << "Equipped: " << game.player().weapon.label() << "\n";
             }
 
         } else if (cmd == "b" || cmd == "best") {
-            if (inv.equipBest()) { player.weapon = *inv.equipped(); std::cout << "Equipped best-by-DPR.\n"; }
+            if (game.equipBest()) std::cout << "Equipped best-by-DPR.\n";
             else std::cout << "Inventory is empty.\n";
 
         } else if (cmd == "a" || cmd == "auto") {
-            autoEquipBetter = !autoEquipBetter;
-            std::cout << "Auto-equip on drop: " << (autoEquipBetter ? "ON" : "OFF") << "\n";
+            game.toggleAuto();
+            std::cout << "Auto-equip on drop: " << (game.autoEquip() ? "ON" : "OFF") << "\n";
 
         } else if (cmd == "r" || cmd == "reset") {
-            reset_battle();
+            const std::size_t before = item_count();
+            game.reset();
+            std::cout << "Battle reset.\n";
+            const std::size_t salvaged = before - item_count();
+            if (salvaged) std::cout << "Auto-salvaged " << salvaged << " item(s).\n";
+
+        } else if (cmd == "s" || cmd == "salvage" || cmd == "autosalvage") {
+            std::string name;
+            Rarity r;
+            if (!(iss >> name) || !parseRarity(name, r)) {
+                std::cout << "Usage: " << (cmd == "autosalvage" ? "autosalvage" : "salvage")
+                          << " <Common|Magic|Rare|Epic|Legendary>\n";
+            } else if (cmd == "autosalvage") {
+                game.setAutoSalvage(r);
+                if (r == Rarity::Common) std::cout << "Auto-salvage: OFF\n";
+                else std::cout << "Auto-salvage on reset: items below " << rarityName(r) << "\n";
+            } else {
+                const std::size_t before = item_count();
+                game.salvage(r);
+                std::cout << "Salvaged " << before - item_count() << " item(s) below " << rarityName(r) << ".\n";
+            }
 
         } else if (cmd == "x" || cmd == "exit") {
             break;
@@ -231,5 +198,10 @@ int main() {
         }
     }
 
+    if (!recordPath.empty()) {
+        if (!saveReplay(recordPath, replay)) { std::cerr << "Could not write " << recordPath << "\n"; return 1; }
+        std::cout << "Replay saved to " << recordPath << " (" << replay.commands.size() << " commands, "
+                  << replay.roundChecksums.size() << " rounds).\n";
+    }
     return 0;
 }
@@ -0,0 +1,142 @@
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "game/content_pack.hpp"
+#include "game/loot_tables.hpp"
+
+using namespace game;
+
+static const char* const kSlotIds[] = {
+    "Weapon", "Offhand", "Armor", "Helmet", "Boots", "Belt", "Amulet", "Ring1", "Ring2"
+};
+
+static bool parseSlot(const std::string& s, Slot& out) {
+    for (int i = 0; i <= static_cast<int>(Slot::Ring2); ++i) {
+        if (s == kSlotIds[i]) { out = static_cast<Slot>(i); return true; }
+    }
+    return false;
+}
+
+// One definition per line, '#' starts a comment line; see
+// content/default_loot.txt. Entries keep their file order, which fixes the
+// alias tables and therefore the draws.
+static bool parseContent(std::istream& in, const std::string& path, LootTables& lt) {
+    std::string line;
+    for (int lineNo = 1; std::getline(in, line); ++lineNo) {
+        std::istringstream ls(line);
+        std::string kind;
+        if (!(ls >> kind) || kind[0] == '#') continue;
+
+        bool ok = false;
+        double weight = 0;
+        std::string word;
+        if (kind == "drop") {
+            ok = ls >> word >> weight && (word == "weapon" || word == "gear");
+            if (ok) lt.dropType.add(word == "gear" ? 1 : 0, weight);
+        } else if (kind == "rarity") {
+            Rarity r;
+            ok = ls >> word >> weight && parseRarity(word, r);
+            if (ok) lt.rarity.add(r, weight);
+        } else if (kind == "weapon") {
+            WeaponBase b;
+            ok = ls >> weight >> std::quoted(b.name) >> b.baseMin >> b.baseMax && b.baseMin <= b.baseMax;
+            if (ok) lt.bases.add(b, weight);
+        } else if (kind == "gear") {
+            GearBase g{Slot::Armor, "", 0, 0};
+            ok = ls >> weight >> word >> std::quoted(g.name) >> g.armorMin >> g.armorMax && parseSlot(word, g.slot) &&
+                 g.armorMin <= g.armorMax;
+            if (ok) lt.gearBases.add(g, weight);
+        } else if (kind == "prefix" || kind == "suffix") {
+            Affix a;
+            ok = ls >> std::quoted(a.name) >> a.flatMin >> a.flatMax >> a.pctDamage >> a.critChance >> a.attackSpeed &&
+                 a.flatMin <= a.flatMax;
+            int minLevel = 1, maxLevel = AffixPool::kMaxLevel;
+            weight = 1.0;
+            char dash = 0;
+            while (ok && ls >> word) {
+                if (word == "levels")      ok = ls >> minLevel >> dash >> maxLevel && dash == '-';
+                else if (word == "weight") ok = static_cast<bool>(ls >> weight);
+                else                       ok = false;
+            }
+            const AffixId id = ok ? internAffix(a) : kNoAffix;
+            if (ok && id == kNoAffix) {
+                std::cerr << path << ":" << lineNo << ": too many distinct affixes\n";
+                return false;
+            }
+            if (ok) (kind == "prefix" ? lt.prefixes : lt.suffixes).add(id, weight, minLevel, maxLevel);
+        }
+        if (ok && ls >> word) ok = false;   // trailing junk
+        if (!ok) {
+            std::cerr << path << ":" << lineNo << ": cannot parse '" << line << "'\n";
+            return false;
+        }
+    }
+    lt.build();
+    return true;
+}
+
+static void dumpPack(const ContentPack& p) {
+    const PackHeader& h = p.header();
+    std::cout << "# " << h.fileSize << " bytes, version " << h.version << "\n";
+    for (std::uint32_t i = 0; i < h.dropType.count; ++i) {
+        std::cout << "drop " << (p.records<std::uint32_t>(h.dropType)[i] ? "gear" : "weapon")
+                  << " " << p.weights(h.dropType)[i] << "\n";
+    }
+    for (std::uint32_t i = 0; i < h.rarity.count; ++i) {
+        std::cout << "rarity " << rarityName(static_cast<Rarity>(p.records<std::uint32_t>(h.rarity)[i]))
+                  << " " << p.weights(h.rarity)[i] << "\n";
+    }
+    for (std::uint32_t i = 0; i < h.weaponBases.count; ++i) {
+        const PackWeaponBase& b = p.records<PackWeaponBase>(h.weaponBases)[i];
+        std::cout << "weapon " << p.weights(h.weaponBases)[i] << " " << std::quoted(std::string(p.str(b.name)))
+                  << " " << b.baseMin << " " << b.baseMax << "\n";
+    }
+    for (std::uint32_t i = 0; i < h.gearBases.count; ++i) {
+        const PackGearBase& g = p.records<PackGearBase>(h.gearBases)[i];
+        std::cout << "gear " << p.weights(h.gearBases)[i] << " " << kSlotIds[g.slot] << " "
+                  << std::quoted(std::string(p.str(g.name))) << " " << g.armorMin << " " << g.armorMax << "\n";
+    }
+    auto affixes = [&](const char* kind, const PackRange& r) {
+        for (std::uint32_t i = 0; i < r.count; ++i) {
+            const PackAffix& a = p.records<PackAffix>(r)[i];
+            std::cout << kind << " " << std::quoted(std::string(p.str(a.name))) << " " << a.flatMin << " "
+                      << a.flatMax << " " << a.pctDamage << " " << a.critChance << " " << a.attackSpeed;
+            if (a.minLevel != 1 || a.maxLevel != AffixPool::kMaxLevel) {
+                std::cout << " levels " << a.minLevel << "-" << a.maxLevel;
+            }
+            if (a.weight != 1.0) std::cout << " weight " << a.weight;
+            std::cout << "\n";
+        }
+    };
+    affixes("prefix", h.prefixes);
+    affixes("suffix", h.suffixes);
+}
+
+static void print_usage() {
+    std::cout <<
+    "Usage: oathbound_packc <definitions.txt> <out.obpk>\n"
+    "       oathbound_packc --dump <pack.obpk>\n"
+    "  Compiles text loot definitions into a content pack for openContentPack(),\n"
+    "  or prints a pack back in the text format.\n";
+}
+
+int main(int argc, char** argv) {
+    if (argc == 3 && !std::strcmp(argv[1], "--dump")) {
+        auto pack = ContentPack::open(argv[2]);
+        if (!pack) { std::cerr << "Not a valid content pack: " << argv[2] << "\n"; return 1; }
+        dumpPack(*pack);
+        return 0;
+    }
+    if (argc != 3 || argv[1][0] == '-') { print_usage(); return 1; }
+
+    std::ifstream in(argv[1]);
+    if (!in) { std::cerr << "Could not read " << argv[1] << "\n"; return 1; }
+    LootTables lt;
+    if (!parseContent(in, argv[1], lt)) return 1;
+    if (!saveContentPack(argv[2], lt)) { std::cerr << "Could not write " << argv[2] << "\n"; return 1; }
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "game/rarity.hpp"
+#include "game/replay.hpp"
+
+using namespace game;
+
+static const char* opName(ReplayOp op) {
+    switch (op) {
+        case ReplayOp::Target:      return "target";
+        case ReplayOp::Next:        return "next";
+        case ReplayOp::Equip:       return "equip";
+        case ReplayOp::Best:        return "best";
+        case ReplayOp::ToggleAuto:  return "auto";
+        case ReplayOp::Reset:       return "reset";
+        case ReplayOp::Salvage:     return "salvage";
+        case ReplayOp::AutoSalvage: return "autosalvage";
+    }
+    return "?";
+}
+
+static void print_usage() {
+    std::cout <<
+    "Usage: oathbound_replay [--dump] <replay>...\n"
+    "  Re-runs each recorded session headless and checks every round checksum.\n"
+    "  --dump             also print the seed and command stream\n";
+}
+
+int main(int argc, char** argv) {
+    bool dump = false;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--dump")) dump = true;
+        else if (argv[i][0] == '-') { print_usage(); return 1; }
+        else files.push_back(argv[i]);
+    }
+    if (files.empty()) { print_usage(); return 1; }
+
+    std::size_t failed = 0;
+    std::uint64_t rounds = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (const auto& path : files) {
+        Replay r;
+        if (!loadReplay(path, r)) {
+            std::cout << "FAIL " << path << ": not a readable replay\n";
+            ++failed;
+            continue;
+        }
+        if (dump) {
+            std::cout << path << ": seed " << r.seed << ", engine " << r.engineId << "\n";
+            for (const auto& c : r.commands) {
+                std::cout << "  " << opName(c.op);
+                if (c.op == ReplayOp::Target || c.op == ReplayOp::Equip) std::cout << " " << c.arg;
+                if (c.op == ReplayOp::Salvage || c.op == ReplayOp::AutoSalvage) {
+                    std::cout << " " << rarityName(static_cast<Rarity>(c.arg));
+                }
+                std::cout << "\n";
+            }
+        }
+        const ReplayCheck chk = verifyReplay(r);
+        rounds += chk.rounds;
+        if (chk.ok) {
+            std::cout << "OK   " << path << ": " << chk.commandsRun << " commands, " << chk.rounds << " rounds\n";
+        } else {
+            std::cout << "FAIL " << path << ": " << chk.error << " (after " << chk.commandsRun << " commands)\n";
+            ++failed;
+        }
+    }
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::cout << std::fixed << std::setprecision(3)
+              << files.size() - failed << "/" << files.size() << " replays verified, "
+              << rounds << " rounds in " << secs << " s\n";
+    return failed ? 1 : 0;
+}
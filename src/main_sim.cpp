@@ -0,0 +1,160 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "game/rarity.hpp"
+#include "game/item.hpp"
+#include "game/actor.hpp"
+#include "game/loot_tables.hpp"
+#include "game/content_pack.hpp"
+#include "game/drop_stats.hpp"
+#include "game/simulation.hpp"
+#include "game/fight_predictor.hpp"
+
+using namespace game;
+
+static Item mkWeapon(const std::string& name, int mn, int mx) {
+    Item w; w.name=name; w.kind=ItemKind::Weapon; w.slot=Slot::Weapon; w.baseMin=mn; w.baseMax=mx; return w;
+}
+
+static void print_usage() {
+    std::cout <<
+    "Usage: oathbound_sim [options]\n"
+    "  --fights <n>       encounters to simulate (default 1000000)\n"
+    "  --seed <n>         RNG seed (default 1337)\n"
+    "  --threads <n>      worker threads, 0 = one per core (default 0)\n"
+    "  --level <n>        loot level (default 1)\n"
+    "  --content <pack>   loot from a compiled content pack (see oathbound_packc)\n"
+    "  --max-rounds <n>   rounds before a fight times out (default 200)\n"
+    "  --no-auto          never auto-equip dropped weapons\n"
+    "  --predict          also print the exact prediction (matches --no-auto)\n"
+    "  --drop-stats <f>   write drop and damage statistics (.csv: combinations only, else JSON)\n"
+    "  --drops <n>        drop-only study: roll n drops instead of fighting\n";
+}
+
+static bool ends_with(const std::string& s, const char* suffix) {
+    const std::size_t n = std::strlen(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+static bool write_drop_stats(const DropStats& d, const std::string& path) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+    if (ends_with(path, ".csv")) d.writeCsv(out); else d.writeJson(out);
+    return bool(out);
+}
+
+int main(int argc, char** argv) {
+    std::uint64_t fights = 1000000;
+    std::uint64_t seed   = 1337;
+    unsigned      threads = 0;
+    bool          predict = false;
+    const char*   content = nullptr;
+    const char*   statsPath = nullptr;
+    std::uint64_t dropStudy = 0;
+
+    SimConfig cfg;
+    cfg.player  = Actor{ "Player", 60, 60, 1, mkWeapon("Rusty Sword", 2, 6) };
+    cfg.enemies = {
+        Actor{"Goblin", 20, 20, 0, mkWeapon("Shiv",    1, 4)},
+        Actor{"Brute",  35, 35, 1, mkWeapon("Club",    3, 7)},
+        Actor{"Raider", 25, 25, 0, mkWeapon("Hatchet", 2, 6)}
+    };
+
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        const bool hasVal = i + 1 < argc;
+        if      (!std::strcmp(a, "--fights") && hasVal)     fights = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(a, "--seed") && hasVal)       seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(a, "--threads") && hasVal)    threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (!std::strcmp(a, "--level") && hasVal)      cfg.level = std::atoi(argv[++i]);
+        else if (!std::strcmp(a, "--max-rounds") && hasVal) cfg.maxRounds = std::atoi(argv[++i]);
+        else if (!std::strcmp(a, "--content") && hasVal)    content = argv[++i];
+        else if (!std::strcmp(a, "--no-auto"))              cfg.autoEquip = false;
+        else if (!std::strcmp(a, "--predict"))              predict = true;
+        else if (!std::strcmp(a, "--drop-stats") && hasVal) statsPath = argv[++i];
+        else if (!std::strcmp(a, "--drops") && hasVal)      dropStudy = std::strtoull(argv[++i], nullptr, 10);
+        else { print_usage(); return 1; }
+    }
+
+    LootTables loot;
+    if (!content) loot = makeDefaultLoot();
+    else if (!openContentPack(content, loot)) {
+        std::cerr << "Could not open content pack " << content << "\n";
+        return 1;
+    }
+
+    DropStats drops;
+    if (dropStudy) {
+        const auto t0 = std::chrono::steady_clock::now();
+        studyDrops(loot, cfg.level, seed, dropStudy, drops, threads);
+        const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        std::cout << "Drops:        " << drops.drops() << "  (" << drops.drops(ItemKind::Weapon) << " weapons, "
+                  << drops.drops(ItemKind::Gear) << " gear)\n"
+                  << "Combinations: " << drops.comboCount() << "  (" << drops.otherDrops() << " drops untracked)\n";
+        for (std::size_t r = 0; r < DropStats::kRarities; ++r) {
+            std::cout << "  " << std::setw(10) << std::left << rarityName(static_cast<Rarity>(r))
+                      << std::right << drops.drops(static_cast<Rarity>(r)) << "\n";
+        }
+        std::cout << std::fixed << std::setprecision(3)
+                  << "Elapsed:      " << secs << " s  ("
+                  << (secs > 0 ? double(drops.drops()) / secs / 1e6 : 0.0) << " M drops/s)\n";
+        if (statsPath && !write_drop_stats(drops, statsPath)) {
+            std::cerr << "Could not write " << statsPath << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    SimStats s = simulateParallel(cfg, loot, seed, fights, threads, statsPath ? &drops : nullptr);
+    const auto t1 = std::chrono::steady_clock::now();
+    const double secs = std::chrono::duration<double>(t1 - t0).count();
+
+    std::cout << std::fixed << std::setprecision(4)
+              << "Encounters:   " << s.encounters << "\n"
+              << "Win rate:     " << s.winRate() << "  (" << s.wins << " wins, "
+              << s.losses << " losses, " << s.timeouts << " timeouts)\n"
+              << "Rounds/win:   " << s.meanRoundsToWin() << "\n"
+              << "HP on win:    " << s.meanHpOnWin() << "/" << cfg.player.maxHP << "\n"
+              << "Auto-equips:  " << s.autoEquips << "\n"
+              << "Drops:\n";
+    for (std::size_t r = 0; r < SimStats::kRarities; ++r) {
+        std::cout << "  " << std::setw(10) << std::left << rarityName(static_cast<Rarity>(r))
+                  << std::right << s.dropsByRarity[r] << "\n";
+    }
+
+    std::cout << "Rounds to win:\n";
+    for (std::size_t r = 0; r < s.roundsToWin.size(); ++r) {
+        if (s.roundsToWin[r]) std::cout << "  " << std::setw(4) << r << "  " << s.roundsToWin[r] << "\n";
+    }
+
+    std::cout << std::setprecision(3)
+              << "Elapsed:      " << secs << " s  ("
+              << (secs > 0 ? double(s.rounds) / secs / 1e6 : 0.0) << " M rounds/s, "
+              << (secs > 0 ? double(s.encounters) / secs / 1e6 : 0.0) << " M fights/s)\n";
+
+    if (predict) {
+        const auto p0 = std::chrono::steady_clock::now();
+        const FightPrediction fp = predictFight(cfg.player, cfg.enemies, cfg.maxRounds);
+        const auto p1 = std::chrono::steady_clock::now();
+        std::cout << std::setprecision(4)
+                  << "Predicted:    win " << fp.pWin << ", loss " << fp.pLoss
+                  << ", timeout " << fp.pTimeout << "\n"
+                  << "  Rounds/win: " << fp.meanRoundsToWin() << "\n"
+                  << "  HP on win:  " << fp.meanHpOnWin() << "/" << cfg.player.maxHP << "\n"
+                  << std::setprecision(3)
+                  << "  Elapsed:    " << std::chrono::duration<double, std::milli>(p1 - p0).count() << " ms\n";
+    }
+    if (statsPath && !write_drop_stats(drops, statsPath)) {
+        std::cerr << "Could not write " << statsPath << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,150 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "game/item.hpp"
+#include "game/actor.hpp"
+#include "game/simulation.hpp"
+#include "game/tuner.hpp"
+
+using namespace game;
+
+static Item mkWeapon(const std::string& name, int mn, int mx) {
+    Item w; w.name=name; w.kind=ItemKind::Weapon; w.slot=Slot::Weapon; w.baseMin=mn; w.baseMax=mx; return w;
+}
+
+static void print_usage() {
+    std::cout <<
+    "Usage: oathbound_tune [options] <param>...\n"
+    "Searches the built-in loot for the configuration closest to the targets,\n"
+    "fighting the Goblin/Brute/Raider pack.\n"
+    "\n"
+    "Params (steps default 5):\n"
+    "  rarity:<Rarity>=lo:hi[:steps]   drop weight of one rarity (default 60/25/10/4/1)\n"
+    "  damage[:<Base>]=lo:hi[:steps]   multiplier on weapon base damage, one base or all\n"
+    "  affix[:<Name>]=lo:hi[:steps]    multiplier on affix stats, one affix or all\n"
+    "\n"
+    "Options:\n"
+    "  --target-win <p>     win rate to aim for (default 0.5)\n"
+    "  --target-rounds <r>  mean rounds per win to aim for (default: ignored)\n"
+    "  --rounds-weight <w>  weight of the rounds miss (default 1)\n"
+    "  --min-fights <n>     first-rung fights per configuration (default 4096)\n"
+    "  --max-fights <n>     fights for the finalists (default 131072)\n"
+    "  --eta <n>            keep 1/n per rung (default 2)\n"
+    "  --max-configs <n>    sample larger grids down to n (default 256)\n"
+    "  --top <n>            configurations to print (default 5)\n"
+    "  --seed <n>           RNG seed (default 1337)\n"
+    "  --threads <n>        worker threads, 0 = one per core (default 0)\n"
+    "  --level <n>          loot level (default 1)\n"
+    "  --max-rounds <n>     rounds before a fight times out (default 200)\n"
+    "  --no-auto            never auto-equip dropped weapons\n";
+}
+
+// "<knob>[:<what>]=lo:hi[:steps]"
+static bool parse_param(const std::string& s, TuneParam& p) {
+    const std::size_t eq = s.find('=');
+    if (eq == std::string::npos) return false;
+    std::string knob = s.substr(0, eq);
+    const std::size_t colon = knob.find(':');
+    if (colon != std::string::npos) {
+        p.what = knob.substr(colon + 1);
+        knob.resize(colon);
+    }
+    if      (knob == "rarity") p.knob = TuneKnob::RarityWeight;
+    else if (knob == "damage") p.knob = TuneKnob::WeaponDamage;
+    else if (knob == "affix")  p.knob = TuneKnob::AffixScale;
+    else return false;
+
+    const char* c = s.c_str() + eq + 1;
+    char* end = nullptr;
+    p.lo = std::strtod(c, &end);
+    if (end == c || *end != ':') return false;
+    c = end + 1;
+    p.hi = std::strtod(c, &end);
+    if (end == c) return false;
+    if (*end == ':') {
+        c = end + 1;
+        p.steps = static_cast<int>(std::strtol(c, &end, 10));
+        if (end == c) return false;
+    }
+    return *end == '\0';
+}
+
+static const char* knob_name(TuneKnob k) {
+    switch (k) {
+        case TuneKnob::RarityWeight: return "rarity";
+        case TuneKnob::WeaponDamage: return "damage";
+        case TuneKnob::AffixScale:   return "affix";
+    }
+    return "?";
+}
+
+int main(int argc, char** argv) {
+    TuneTarget  target;
+    TuneOptions opt;
+    std::size_t top = 5;
+    std::vector<TuneParam> params;
+
+    SimConfig cfg;
+    cfg.player  = Actor{ "Player", 60, 60, 1, mkWeapon("Rusty Sword", 2, 6) };
+    cfg.enemies = {
+        Actor{"Goblin", 20, 20, 0, mkWeapon("Shiv",    1, 4)},
+        Actor{"Brute",  35, 35, 1, mkWeapon("Club",    3, 7)},
+        Actor{"Raider", 25, 25, 0, mkWeapon("Hatchet", 2, 6)}
+    };
+
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        const bool hasVal = i + 1 < argc;
+        if      (!std::strcmp(a, "--target-win") && hasVal)    target.winRate = std::atof(argv[++i]);
+        else if (!std::strcmp(a, "--target-rounds") && hasVal) target.roundsToWin = std::atof(argv[++i]);
+        else if (!std::strcmp(a, "--rounds-weight") && hasVal) target.roundsWeight = std::atof(argv[++i]);
+        else if (!std::strcmp(a, "--min-fights") && hasVal)    opt.minEncounters = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(a, "--max-fights") && hasVal)    opt.maxEncounters = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(a, "--eta") && hasVal)           opt.eta = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (!std::strcmp(a, "--max-configs") && hasVal)   opt.maxConfigs = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(a, "--top") && hasVal)           top = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(a, "--seed") && hasVal)          opt.seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(a, "--threads") && hasVal)       opt.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (!std::strcmp(a, "--level") && hasVal)         cfg.level = std::atoi(argv[++i]);
+        else if (!std::strcmp(a, "--max-rounds") && hasVal)    cfg.maxRounds = std::atoi(argv[++i]);
+        else if (!std::strcmp(a, "--no-auto"))                 cfg.autoEquip = false;
+        else {
+            TuneParam p;
+            if (a[0] == '-' || !parse_param(a, p)) { print_usage(); return 1; }
+            params.push_back(p);
+        }
+    }
+    if (params.empty()) { print_usage(); return 1; }
+    if (!TunedLoot().valid(params)) {
+        std::cerr << "Unknown rarity, base or affix name, or a bad range\n";
+        return 1;
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    const TuneResult r = tune(cfg, params, target, opt);
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::cout << "Configurations: " << r.configs.size() << ", rungs: " << r.rungs
+              << ", fights: " << r.encounters << "\n";
+    for (std::size_t i = 0; i < r.configs.size() && i < top; ++i) {
+        const TuneConfig& c = r.configs[i];
+        std::cout << "#" << (i + 1) << std::fixed << std::setprecision(4)
+                  << "  loss " << c.loss << "  win " << c.stats.winRate()
+                  << "  rounds/win " << std::setprecision(2) << c.stats.meanRoundsToWin()
+                  << "  (" << c.stats.encounters << " fights)\n   ";
+        for (std::size_t k = 0; k < params.size(); ++k) {
+            std::cout << " " << knob_name(params[k].knob) << (params[k].what.empty() ? "" : ":")
+                      << params[k].what << "=" << std::setprecision(3) << c.values[k];
+        }
+        std::cout << "\n";
+    }
+    std::cout << std::setprecision(3) << "Elapsed: " << secs << " s  ("
+              << (secs > 0 ? double(r.encounters) / secs / 1e6 : 0.0) << " M fights/s)\n";
+    return 0;
+}
@@ -15,6 +15,8 @@
 #include "game/inventory.hpp"
 #include "game/loot_tables.hpp"
 #include "game/combat_math.hpp"
+#include "game/combat_event.hpp"
+#include "core/spsc_ring.hpp"
 
 using namespace game;
 
@@ -31,15 +33,25 @@ enum {
     ID_BTN_RESET,
     ID_EDIT_LOG,
     ID_STATIC_PLAYER,
-    ID_CHK_AUTO
+    ID_CHK_AUTO,
+    ID_CHK_SALVAGE
 };
 
 struct UI {
     HWND hWeap{}, hGear{}, hEnemies{};
     HWND hEqMain{}, hEqOff{}, hEqGear{}, hBest{};
-    HWND hNext{}, hReset{}, hLog{}, hPlayer{}, hAuto{};
+    HWND hNext{}, hReset{}, hLog{}, hPlayer{}, hAuto{}, hSalvage{};
 };
 
+// A log row is either a fixed UI notice or a combat event; both are cheap to
+// store and only the rows shown in the log control get formatted.
+struct LogLine {
+    const char* notice = nullptr;
+    CombatEvent ev;
+};
+
+constexpr std::size_t kLogVisible = 64;   // rows rendered into the log control
+
 struct App {
     core::RNG rng{1337};
     LootTables loot = makeDefaultLoot();
@@ -47,16 +59,23 @@ struct App {
     Actor player{ "Player", 60, 60, 1, Item{} };
     std::vector<Actor> enemies;
     bool autoEquipBetter = true;
-    std::vector<std::string> log;
+    bool salvageCommons = false;          // on reset, once the log no longer names them
+    CombatEventRing events{1024};         // filled by do_round, drained into log
+    core::HistoryRing<LogLine> log{512};
+    CombatRoster roster;                  // names for the events in log
+    std::uint32_t round = 0;
     UI ui;
 };
 
 static App* g = nullptr;
 
 // ---------- helpers ----------
-static void push_log(const std::string& s) {
-    if (g->log.size() > 800) g->log.erase(g->log.begin(), g->log.begin()+400);
-    g->log.push_back(s);
+static void push_log(const char* s) {
+    g->log.push(LogLine{s, CombatEvent{}});
+}
+
+static void drain_events() {
+    g->events.drain([](const CombatEvent& e){ g->log.push(LogLine{nullptr, e}); });
 }
 
 static Item mkWeapon(const std::string& name,int mn,int mx,bool twoH=false){
@@ -92,7 +111,13 @@ static std::vector<Actor> make_enemies_random(core::RNG& rng) {
 
 static void refresh_log() {
     std::ostringstream os;
-    for (auto& s: g->log) os << s << "\r\n";
+    const size_t n = g->log.size();
+    for (size_t i = n > kLogVisible ? n - kLogVisible : 0; i < n; ++i) {
+        const LogLine& l = g->log[i];
+        if (l.notice) os << l.notice;
+        else formatEvent(os, l.ev, g->roster, &g->inv);
+        os << "\r\n";
+    }
     SetWindowTextA(g->ui.hLog, os.str().c_str());
     SendMessageA(g->ui.hLog, EM_SETSEL, (WPARAM)-1, (LPARAM)-1);
     SendMessageA(g->ui.hLog, EM_SCROLLCARET, 0, 0);
@@ -148,48 +173,54 @@ static void do_round() {
     if (it == g->enemies.end()) { push_log("No enemies alive. Reset."); refresh_log(); return; }
     Actor& target = *it;
 
+    const std::uint32_t round = ++g->round;
+    const std::uint16_t targetId = enemyActor(static_cast<size_t>(it - g->enemies.begin()));
+    g->events.push(CombatEvent{round, CombatEventKind::RoundStart, 0, kNoActor, kNoActor, 0, 0, kNoDrop});
+
     // Main-hand hits
     int hits = std::max(1, (int)std::round(expectedAPS(*mh, b.attackSpeed)));
     for (int h=0; h<hits && target.alive(); ++h) {
-        int dmg = g->player.attack(target, g->rng, b.pctDamage, b.critChance);
+        bool crit = false;
+        int dmg = g->player.attack(target, g->rng, b.pctDamage, b.critChance, &crit);
         target.hp -= dmg;
-        std::ostringstream os; os << "You hit " << target.name << " for " << dmg
-                                  << " (" << std::max(0,target.hp) << "/" << target.maxHP << ")";
-        push_log(os.str());
+        g->events.push(CombatEvent{round, CombatEventKind::Hit, crit ? kEventCrit : std::uint8_t(0),
+                                   kPlayerActor, targetId, dmg, target.hp, kNoDrop});
     }
 
     // Off-hand (one swing)
     if (target.alive()) {
         if (const Item* oh = g->inv.equippedOffhand()) {
-            int d = rollDamageWithBonuses(*oh, g->rng, b.pctDamage, b.critChance);
-            d = std::max(0, d - target.armor);
+            bool crit = false;
+            int d = rollDamage(makeSwingProfile(*oh, b.pctDamage, b.critChance), g->rng, crit);
+            d = applyArmor(d, target.armor);
             target.hp -= d;
-            std::ostringstream os; os << "You (OH) hit " << target.name << " for " << d
-                                      << " (" << std::max(0,target.hp) << "/" << target.maxHP << ")";
-            push_log(os.str());
+            g->events.push(CombatEvent{round, CombatEventKind::Hit,
+                                       static_cast<std::uint8_t>(kEventOffhand | (crit ? kEventCrit : 0)),
+                                       kPlayerActor, targetId, d, target.hp, kNoDrop});
         }
     }
 
     // Death & drop
     if (!target.alive()) {
-        std::ostringstream os; os << target.name << " is slain!"; push_log(os.str());
+        g->events.push(CombatEvent{round, CombatEventKind::Slain, 0, kPlayerActor, targetId, 0, 0, kNoDrop});
 
         if (g->loot.rollIsGear(g->rng)) {
-            Item ge = g->loot.rollGear(g->rng, 1);
-            g->inv.addGear(ge);
-            push_log(std::string("Drop: ") + ge.label());
+            size_t idx = g->inv.addGear(g->loot.rollGear(g->rng, 1));
+            g->events.push(CombatEvent{round, CombatEventKind::Drop, kEventGear, kNoActor, targetId, 0, 0,
+                                       static_cast<std::uint32_t>(idx)});
             refresh_gear();
         } else {
-            Item we = g->loot.rollWeapon(g->rng, 1);
-            size_t idx = g->inv.addWeapon(we);
-            push_log(std::string("Drop: ") + we.label());
+            size_t idx = g->inv.addWeapon(g->loot.rollWeapon(g->rng, 1));
+            g->events.push(CombatEvent{round, CombatEventKind::Drop, 0, kNoActor, targetId, 0, 0,
+                                       static_cast<std::uint32_t>(idx)});
             if (g->autoEquipBetter && mh) {
                 double cur  = expectedDPR(*mh, b.pctDamage, b.critChance, b.attackSpeed);
                 double cand = expectedDPR(g->inv.weaponAt(idx), b.pctDamage, b.critChance, b.attackSpeed);
                 if (cand > cur) {
                     g->inv.equip(idx);
                     g->player.weapon = g->inv.weaponAt(idx);
-                    push_log("Auto-equipped better weapon.");
+                    g->events.push(CombatEvent{round, CombatEventKind::AutoEquip, 0, kPlayerActor, kNoActor, 0, 0,
+                                               static_cast<std::uint32_t>(idx)});
                 }
             }
             refresh_weapons();
@@ -197,21 +228,24 @@ static void do_round() {
     }
 
     // Enemy swings
-    for (auto& e : g->enemies) {
+    for (size_t i = 0; i < g->enemies.size(); ++i) {
+        Actor& e = g->enemies[i];
         if (!e.alive() || !g->player.alive()) continue;
         int swings = std::max(1, (int)std::round(1.0 + e.weapon.attackSpeed()));
         for (int s=0; s<swings && g->player.alive(); ++s) {
-            int d = e.attack(g->player, g->rng);
+            bool crit = false;
+            int d = e.attack(g->player, g->rng, 0.0, 0.0, &crit);
             g->player.hp -= d;
-            std::ostringstream os; os << e.name << " hits you for " << d
-                                      << " (You: " << std::max(0,g->player.hp) << "/" << g->player.maxHP << ")";
-            push_log(os.str());
+            g->events.push(CombatEvent{round, CombatEventKind::Hit, crit ? kEventCrit : std::uint8_t(0),
+                                       enemyActor(i), kPlayerActor, d, g->player.hp, kNoDrop});
         }
     }
 
-    if (!g->player.alive()) push_log("Defeat. You died.");
-    else if (std::none_of(g->enemies.begin(), g->enemies.end(), [](const Actor& a){return a.alive();}))
-        push_log("Victory! All enemies defeated.");
+    if (!g->player.alive() || std::none_of(g->enemies.begin(), g->enemies.end(), [](const Actor& a){return a.alive();})) {
+        g->events.push(CombatEvent{round, g->player.alive() ? CombatEventKind::Victory : CombatEventKind::Defeat,
+                                   0, kPlayerActor, kNoActor, 0, g->player.hp, kNoDrop});
+    }
+    drain_events();
 
     refresh_enemies();
     refresh_player();
@@ -222,7 +256,15 @@ static void reset_battle() {
     if (auto mh = g->inv.equipped()) g->player.weapon = *mh;
     g->player.hp = g->player.maxHP;
     g->enemies = make_enemies_random(g->rng);
+    g->roster = CombatRoster::of(g->player, g->enemies);
+    g->round = 0;
+    g->log.clear();   // old events name the previous pack
     push_log("Battle reset.");
+    if (g->salvageCommons && g->inv.salvageBelow(Rarity::Magic) > 0) {
+        push_log("Salvaged unequipped Common items.");
+        refresh_weapons();
+        refresh_gear();
+    }
     refresh_enemies();
     refresh_player();
     refresh_log();
@@ -254,6 +296,7 @@ static void layout_controls(HWND hWnd) {
     MoveWindow(g->ui.hBest,   rx + 130, pad + 2*topH, 120, 26, TRUE);
 
     MoveWindow(g->ui.hAuto, rx + 260, pad + 2*topH, 160, 26, TRUE);
+    MoveWindow(g->ui.hSalvage, rx + 430, pad + 2*topH, 200, 26, TRUE);
 
     MoveWindow(g->ui.hLog, rx, h - pad - 26, rw, 26, TRUE);
 }
@@ -272,6 +315,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
             g->inv.addGear(mkGear("Leather Armor", Slot::Armor, 3));
 
             g->enemies = make_enemies_random(g->rng);
+            g->roster = CombatRoster::of(g->player, g->enemies);
             push_log("Welcome! Equip items and click Next Round.");
 
             HFONT font = (HFONT)GetStockObject(DEFAULT_GUI_FONT);
@@ -302,6 +346,8 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
             g->ui.hAuto    = CreateWindowExA(0, "BUTTON", "Auto-equip drops",
                                  WS_CHILD|WS_VISIBLE|BS_AUTOCHECKBOX, 0,0,0,0, hWnd, (HMENU)ID_CHK_AUTO, GetModuleHandle(nullptr), nullptr);
             SendMessage(g->ui.hAuto, BM_SETCHECK, BST_CHECKED, 0);
+            g->ui.hSalvage = CreateWindowExA(0, "BUTTON", "Salvage Commons on reset",
+                                 WS_CHILD|WS_VISIBLE|BS_AUTOCHECKBOX, 0,0,0,0, hWnd, (HMENU)ID_CHK_SALVAGE, GetModuleHandle(nullptr), nullptr);
 
             g->ui.hLog     = CreateWindowExA(WS_EX_CLIENTEDGE, "EDIT", "",
                                  WS_CHILD|WS_VISIBLE|ES_READONLY|ES_AUTOHSCROLL,
@@ -309,7 +355,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
 
             for (HWND ctl : { g->ui.hPlayer, g->ui.hEnemies, g->ui.hNext, g->ui.hReset,
                               g->ui.hWeap, g->ui.hEqMain, g->ui.hEqOff, g->ui.hGear,
-                              g->ui.hEqGear, g->ui.hBest, g->ui.hLog, g->ui.hAuto }) {
+                              g->ui.hEqGear, g->ui.hBest, g->ui.hLog, g->ui.hAuto, g->ui.hSalvage }) {
                 SendMessage(ctl, WM_SETFONT, (WPARAM)font, TRUE);
             }
 
@@ -382,6 +428,12 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
                 return 0;
             }
 
+            if (id == ID_CHK_SALVAGE && code == BN_CLICKED) {
+                LRESULT st = SendMessage(g->ui.hSalvage, BM_GETCHECK, 0, 0);
+                g->salvageCommons = (st == BST_CHECKED);
+                return 0;
+            }
+
             break;
         }
 
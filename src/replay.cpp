@@ -0,0 +1,148 @@
+#include "game/replay.hpp"
+#include "game/session.hpp"
+#include <algorithm>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <string>
+
+namespace game {
+
+static constexpr char kMagic[4] = {'O', 'B', 'R', 'P'};
+static constexpr std::uint8_t kHasChecksum = 0x80;
+
+static void putLE(std::ostream& os, std::uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i) os.put(static_cast<char>((v >> (8 * i)) & 0xFF));
+}
+
+static bool getLE(std::istream& is, std::uint64_t& v, int bytes) {
+    v = 0;
+    for (int i = 0; i < bytes; ++i) {
+        const int c = is.get();
+        if (c == std::char_traits<char>::eof()) return false;
+        v |= static_cast<std::uint64_t>(static_cast<unsigned char>(c)) << (8 * i);
+    }
+    return true;
+}
+
+static void putVarint(std::ostream& os, std::int32_t v) {
+    std::uint32_t z = (static_cast<std::uint32_t>(v) << 1) ^ static_cast<std::uint32_t>(v >> 31);
+    while (z >= 0x80) { os.put(static_cast<char>((z & 0x7F) | 0x80)); z >>= 7; }
+    os.put(static_cast<char>(z));
+}
+
+static bool getVarint(std::istream& is, std::int32_t& v) {
+    std::uint32_t z = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        const int c = is.get();
+        if (c == std::char_traits<char>::eof()) return false;
+        z |= static_cast<std::uint32_t>(c & 0x7F) << shift;
+        if (!(c & 0x80)) {
+            v = static_cast<std::int32_t>((z >> 1) ^ (~(z & 1) + 1));
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool hasArg(ReplayOp op) {
+    return op == ReplayOp::Target || op == ReplayOp::Equip || op == ReplayOp::Salvage || op == ReplayOp::AutoSalvage;
+}
+
+bool writeReplay(std::ostream& os, const Replay& r) {
+    os.write(kMagic, sizeof kMagic);
+    putLE(os, Replay::kVersion, 2);
+    putLE(os, r.engineId, 2);
+    putLE(os, r.seed, 8);
+    putLE(os, r.commands.size(), 4);
+
+    std::size_t nextSum = 0;
+    for (const auto& c : r.commands) {
+        const bool sum = c.op == ReplayOp::Next && c.arg != 0;
+        if (sum && nextSum >= r.roundChecksums.size()) return false;
+        os.put(static_cast<char>(static_cast<std::uint8_t>(c.op) | (sum ? kHasChecksum : 0)));
+        if (hasArg(c.op)) putVarint(os, c.arg);
+        if (sum) putLE(os, r.roundChecksums[nextSum++], 4);
+    }
+    return static_cast<bool>(os);
+}
+
+bool readReplay(std::istream& is, Replay& r) {
+    char magic[4];
+    if (!is.read(magic, sizeof magic) || !std::equal(magic, magic + 4, kMagic)) return false;
+
+    std::uint64_t version = 0, engine = 0, seed = 0, count = 0;
+    if (!getLE(is, version, 2) || version < 1 || version > Replay::kVersion) return false;
+    const ReplayOp lastOp = version == 1 ? ReplayOp::Reset : ReplayOp::AutoSalvage;
+    if (!getLE(is, engine, 2) || !getLE(is, seed, 8) || !getLE(is, count, 4)) return false;
+
+    Replay out;
+    out.engineId = static_cast<std::uint32_t>(engine);
+    out.seed     = seed;
+    // The count is untrusted: reserve at most 4096 commands and let a short
+    // file fail on end-of-file below.
+    out.commands.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(count, 4096)));
+    for (std::uint64_t i = 0; i < count; ++i) {
+        const int b = is.get();
+        if (b == std::char_traits<char>::eof()) return false;
+        const auto raw = static_cast<std::uint8_t>(b & ~kHasChecksum);
+        if (raw > static_cast<std::uint8_t>(lastOp)) return false;
+
+        ReplayCommand c{static_cast<ReplayOp>(raw), 0};
+        if (hasArg(c.op) && !getVarint(is, c.arg)) return false;
+        if (b & kHasChecksum) {
+            std::uint64_t sum = 0;
+            if (c.op != ReplayOp::Next || !getLE(is, sum, 4)) return false;
+            out.roundChecksums.push_back(static_cast<std::uint32_t>(sum));
+            c.arg = 1;
+        }
+        out.commands.push_back(c);
+    }
+    r = std::move(out);
+    return true;
+}
+
+bool saveReplay(const std::string& path, const Replay& r) {
+    std::ofstream f(path, std::ios::binary);
+    return f && writeReplay(f, r);
+}
+
+bool loadReplay(const std::string& path, Replay& r) {
+    std::ifstream f(path, std::ios::binary);
+    return f && readReplay(f, r);
+}
+
+ReplayCheck verifyReplay(const Replay& r) {
+    ReplayCheck res;
+    if (r.engineId != core::kRngEngineId) {
+        res.error = "recorded with RNG engine " + std::to_string(r.engineId) +
+                    ", this build uses " + std::to_string(core::kRngEngineId);
+        return res;
+    }
+
+    Session s(r.seed);
+    std::size_t nextSum = 0;
+    for (const auto& c : r.commands) {
+        const bool played = s.apply(c);
+        ++res.commandsRun;
+        if (c.op != ReplayOp::Next) continue;
+        if (played != (c.arg != 0)) {
+            res.error = played ? "a round was played that the recording skipped"
+                               : "the recording played a round that could not be played";
+            res.firstBadRound = static_cast<long>(nextSum) + 1;
+            return res;
+        }
+        if (!played) continue;
+        ++res.rounds;
+        if (nextSum >= r.roundChecksums.size() || r.roundChecksums[nextSum] != s.checksum()) {
+            res.firstBadRound = static_cast<long>(nextSum) + 1;
+            res.error = "checksum mismatch after recorded round " + std::to_string(nextSum + 1);
+            return res;
+        }
+        ++nextSum;
+    }
+    res.ok = true;
+    return res;
+}
+
+} // namespace game
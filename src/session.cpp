@@ -0,0 +1,198 @@
+#include "game/session.hpp"
+#include "game/combat_math.hpp"
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace game {
+
+static Item mkWeapon(const std::string& name, int mn, int mx) {
+    Item w; w.name=name; w.kind=ItemKind::Weapon; w.slot=Slot::Weapon; w.baseMin=mn; w.baseMax=mx; return w;
+}
+
+static std::vector<Actor> makeEnemies() {
+    return {
+        Actor{"Goblin", 20, 20, 0, mkWeapon("Shiv",    1, 4)},
+        Actor{"Brute",  35, 35, 1, mkWeapon("Club",    3, 7)},
+        Actor{"Raider", 25, 25, 0, mkWeapon("Hatchet", 2, 6)}
+    };
+}
+
+static bool isRarity(int r) { return r >= 0 && r <= static_cast<int>(Rarity::Legendary); }
+
+Session::Session(std::uint64_t seed, CombatEventRing* events)
+    : seed_(seed), rng_(seed), loot_(makeDefaultLoot()), events_(events) {
+    inv_.equip(inv_.addWeapon(mkWeapon("Rusty Sword", 2, 6)));
+    player_  = Actor{ "Player", 60, 60, 1, *inv_.equipped() };
+    enemies_ = makeEnemies();
+    roster_  = CombatRoster::of(player_, enemies_);
+}
+
+void Session::record(Replay* out) {
+    recorder_ = out;
+    if (out) {
+        out->seed     = seed_;
+        out->engineId = core::kRngEngineId;
+        out->commands.clear();
+        out->roundChecksums.clear();
+    }
+}
+
+bool Session::anyEnemyAlive() const {
+    return std::any_of(enemies_.begin(), enemies_.end(), [](const Actor& e){ return e.alive(); });
+}
+
+bool Session::target(int idx) {
+    if (recorder_) recorder_->commands.push_back(ReplayCommand{ReplayOp::Target, idx});
+    if (idx < 0 || idx >= static_cast<int>(enemies_.size())) return false;
+    selected_ = idx;
+    return true;
+}
+
+bool Session::next() {
+    const bool play = player_.alive() && anyEnemyAlive();
+    if (play) {
+        ++round_;
+        playerTurn();
+        enemiesTurn();
+        if (!player_.alive() || !anyEnemyAlive()) {
+            emit(CombatEvent{round_, player_.alive() ? CombatEventKind::Victory : CombatEventKind::Defeat,
+                             0, kPlayerActor, kNoActor, 0, player_.hp, kNoDrop});
+        }
+    }
+    if (recorder_) {
+        recorder_->commands.push_back(ReplayCommand{ReplayOp::Next, play ? 1 : 0});
+        if (play) recorder_->roundChecksums.push_back(checksum());
+    }
+    return play;
+}
+
+bool Session::equip(int idx) {
+    if (recorder_) recorder_->commands.push_back(ReplayCommand{ReplayOp::Equip, idx});
+    if (idx < 0 || idx >= static_cast<int>(inv_.weaponsCount())) return false;
+    inv_.equip(static_cast<std::size_t>(idx));
+    player_.weapon = *inv_.equipped();
+    return true;
+}
+
+bool Session::equipBest() {
+    if (recorder_) recorder_->commands.push_back(ReplayCommand{ReplayOp::Best, 0});
+    if (!inv_.equipBest()) return false;
+    player_.weapon = *inv_.equipped();
+    return true;
+}
+
+void Session::toggleAuto() {
+    if (recorder_) recorder_->commands.push_back(ReplayCommand{ReplayOp::ToggleAuto, 0});
+    autoEquip_ = !autoEquip_;
+}
+
+void Session::reset() {
+    if (recorder_) recorder_->commands.push_back(ReplayCommand{ReplayOp::Reset, 0});
+    inv_.salvageBelow(autoSalvage_);
+    player_   = Actor{ "Player", 60, 60, 1, *inv_.equipped() };
+    enemies_  = makeEnemies();
+    roster_   = CombatRoster::of(player_, enemies_);
+    selected_ = 0;
+    round_    = 0;
+}
+
+bool Session::salvage(Rarity below) {
+    if (recorder_) recorder_->commands.push_back(ReplayCommand{ReplayOp::Salvage, static_cast<int>(below)});
+    return inv_.salvageBelow(below) > 0;
+}
+
+void Session::setAutoSalvage(Rarity below) {
+    if (recorder_) recorder_->commands.push_back(ReplayCommand{ReplayOp::AutoSalvage, static_cast<int>(below)});
+    autoSalvage_ = below;
+}
+
+bool Session::apply(const ReplayCommand& c) {
+    switch (c.op) {
+        case ReplayOp::Target:     return target(c.arg);
+        case ReplayOp::Next:       return next();
+        case ReplayOp::Equip:      return equip(c.arg);
+        case ReplayOp::Best:       return equipBest();
+        case ReplayOp::ToggleAuto: toggleAuto(); return true;
+        case ReplayOp::Reset:      reset(); return true;
+        case ReplayOp::Salvage:    return isRarity(c.arg) && salvage(static_cast<Rarity>(c.arg));
+        case ReplayOp::AutoSalvage:
+            if (!isRarity(c.arg)) return false;
+            setAutoSalvage(static_cast<Rarity>(c.arg));
+            return true;
+    }
+    return false;
+}
+
+void Session::playerTurn() {
+    // Choose target: preferred selected enemy if alive; else first alive.
+    auto it = enemies_.end();
+    if (selected_ >= 0 && selected_ < static_cast<int>(enemies_.size()) && enemies_[selected_].alive()) {
+        it = enemies_.begin() + selected_;
+    } else {
+        it = std::find_if(enemies_.begin(), enemies_.end(), [](const Actor& e){ return e.alive(); });
+    }
+    if (it == enemies_.end()) return;
+
+    Actor& target = *it;
+    const std::uint16_t targetId = enemyActor(static_cast<std::size_t>(it - enemies_.begin()));
+    const int hits = swingsPerRound(player_.weapon);
+    for (int h = 0; h < hits && target.alive(); ++h) {
+        bool crit = false;
+        int dmg = player_.attack(target, rng_, 0.0, 0.0, &crit);
+        target.hp -= dmg;
+        emit(CombatEvent{round_, CombatEventKind::Hit, crit ? kEventCrit : std::uint8_t(0),
+                         kPlayerActor, targetId, dmg, target.hp, kNoDrop});
+    }
+    if (!target.alive()) {
+        emit(CombatEvent{round_, CombatEventKind::Slain, 0, kPlayerActor, targetId, 0, 0, kNoDrop});
+        std::size_t idx = inv_.addWeapon(loot_.rollWeapon(rng_, 1));
+        emit(CombatEvent{round_, CombatEventKind::Drop, 0, kNoActor, targetId, 0, 0,
+                         static_cast<std::uint32_t>(idx)});
+
+        if (autoEquip_) {
+            const double cur  = expectedDPR(player_.weapon);
+            const double cand = expectedDPR(inv_.weaponAt(idx));
+            if (cand > cur) {
+                inv_.equip(idx);
+                player_.weapon = *inv_.equipped();
+                emit(CombatEvent{round_, CombatEventKind::AutoEquip, 0, kPlayerActor, kNoActor, 0, 0,
+                                 static_cast<std::uint32_t>(idx)});
+            }
+        }
+    }
+}
+
+void Session::enemiesTurn() {
+    for (std::size_t i = 0; i < enemies_.size(); ++i) {
+        const Actor& e = enemies_[i];
+        if (!e.alive() || !player_.alive()) continue;
+        const int hits = swingsPerRound(e.weapon);
+        for (int h = 0; h < hits && player_.alive(); ++h) {
+            bool crit = false;
+            int dmg = e.attack(player_, rng_, 0.0, 0.0, &crit);
+            player_.hp -= dmg;
+            emit(CombatEvent{round_, CombatEventKind::Hit, crit ? kEventCrit : std::uint8_t(0),
+                             enemyActor(i), kPlayerActor, dmg, player_.hp, kNoDrop});
+        }
+    }
+}
+
+std::uint32_t Session::checksum() const {
+    std::uint64_t h = 0xcbf29ce484222325ull;
+    auto mix = [&h](std::uint64_t v) {
+        for (int b = 0; b < 8; ++b) { h ^= (v >> (8 * b)) & 0xFF; h *= 0x100000001b3ull; }
+    };
+    mix(round_);
+    mix(static_cast<std::uint64_t>(player_.hp));
+    for (const auto& e : enemies_) mix(static_cast<std::uint64_t>(e.hp));
+    mix(inv_.weaponsCount());
+    mix(inv_.loadout().mainHand);
+    mix(static_cast<std::uint64_t>(selected_));
+    mix(autoEquip_ ? 1 : 0);
+    core::RNG probe = rng_;   // next draw identifies the RNG position
+    mix(probe.next());
+    return static_cast<std::uint32_t>(h ^ (h >> 32));
+}
+
+} // namespace game
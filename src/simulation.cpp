@@ -0,0 +1,204 @@
+#include "game/simulation.hpp"
+#include "game/combat_math.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory_resource>
+#include <thread>
+
+namespace game {
+
+static double meanOf(const std::vector<std::uint64_t>& hist) {
+    std::uint64_t n = 0;
+    double sum = 0.0;
+    for (std::size_t i = 0; i < hist.size(); ++i) {
+        n   += hist[i];
+        sum += double(i) * double(hist[i]);
+    }
+    return n ? sum / double(n) : 0.0;
+}
+
+double SimStats::meanRoundsToWin() const { return meanOf(roundsToWin); }
+double SimStats::meanHpOnWin() const     { return meanOf(hpOnWin); }
+
+static void addHist(std::vector<std::uint64_t>& dst, const std::vector<std::uint64_t>& src) {
+    if (dst.size() < src.size()) dst.resize(src.size(), 0);
+    for (std::size_t i = 0; i < src.size(); ++i) dst[i] += src[i];
+}
+
+void SimStats::merge(const SimStats& o) {
+    encounters += o.encounters;
+    wins       += o.wins;
+    losses     += o.losses;
+    timeouts   += o.timeouts;
+    rounds     += o.rounds;
+    kills      += o.kills;
+    autoEquips += o.autoEquips;
+    addHist(roundsToWin, o.roundsToWin);
+    addHist(hpOnWin, o.hpOnWin);
+    for (std::size_t r = 0; r < kRarities; ++r) dropsByRarity[r] += o.dropsByRarity[r];
+}
+
+SimStats simulate(const SimConfig& cfg, const LootTables& loot, core::RNG& rng, std::uint64_t encounters,
+                  DropStats* drops) {
+    SimStats s;
+    s.roundsToWin.assign(static_cast<std::size_t>(std::max(0, cfg.maxRounds)) + 1, 0);
+    s.hpOnWin.assign(static_cast<std::size_t>(std::max(0, cfg.player.maxHP)) + 1, 0);
+
+    // Working copies live in one arena for the whole batch, released in one
+    // go on return. They are reset in place between encounters, and drops are
+    // rolled into one reused Item, so the hot loop never allocates.
+    alignas(std::max_align_t) unsigned char buf[4096];
+    std::pmr::monotonic_buffer_resource arena(buf, sizeof buf);
+    const Item::allocator_type alloc(&arena);
+
+    Actor player(cfg.player, alloc);
+    std::pmr::vector<Actor> enemies(cfg.enemies.begin(), cfg.enemies.end(), alloc);
+    std::pmr::vector<int> enemyHits(enemies.size(), alloc);
+    std::pmr::vector<SwingProfile> enemySwing(enemies.size(), alloc);
+    Item drop(alloc);
+    for (std::size_t i = 0; i < enemies.size(); ++i) {
+        enemyHits[i]  = swingsPerRound(enemies[i].weapon);
+        enemySwing[i] = makeSwingProfile(enemies[i].weapon);
+    }
+
+    const int          baseHits  = swingsPerRound(cfg.player.weapon);
+    const double       baseDPR   = expectedDPR(cfg.player.weapon);
+    const SwingProfile baseSwing = makeSwingProfile(cfg.player.weapon);
+
+    for (std::uint64_t n = 0; n < encounters; ++n) {
+        bool swapped = false;
+        int    playerHits = baseHits;
+        double playerDPR  = baseDPR;
+        SwingProfile playerSwing = baseSwing;
+        player.hp = cfg.player.hp;
+        for (std::size_t i = 0; i < enemies.size(); ++i) enemies[i].hp = cfg.enemies[i].hp;
+
+        // Enemies only ever die and the player always hits the first alive one,
+        // so the target cursor moves forward monotonically.
+        std::size_t first = 0;
+        while (first < enemies.size() && !enemies[first].alive()) ++first;
+
+        int round = 0;
+        while (player.alive() && first < enemies.size() && round < cfg.maxRounds) {
+            ++round;
+
+            // Player turn
+            Actor& target = enemies[first];
+            for (int h = 0; h < playerHits && target.alive(); ++h) {
+                const int dmg = applyArmor(rollDamage(playerSwing, rng), target.armor);
+                target.hp -= dmg;
+                if (drops) drops->addDealt(dmg);
+            }
+            if (!target.alive()) {
+                ++s.kills;
+                loot.rollWeaponInto(rng, cfg.level, drop);
+                ++s.dropsByRarity[static_cast<std::size_t>(drop.rarity)];
+                if (drops) {
+                    drops->addKills();
+                    drops->addDrop(drop);
+                }
+                if (cfg.autoEquip) {
+                    const double cand = expectedDPR(drop);
+                    if (cand > playerDPR) {
+                        player.weapon = drop;
+                        playerHits  = swingsPerRound(player.weapon);
+                        playerSwing = makeSwingProfile(player.weapon);
+                        playerDPR  = cand;
+                        swapped    = true;
+                        ++s.autoEquips;
+                    }
+                }
+                while (first < enemies.size() && !enemies[first].alive()) ++first;
+            }
+
+            // Enemies' turn
+            for (std::size_t i = first; i < enemies.size() && player.alive(); ++i) {
+                if (!enemies[i].alive()) continue;
+                for (int h = 0; h < enemyHits[i] && player.alive(); ++h) {
+                    const int dmg = applyArmor(rollDamage(enemySwing[i], rng), player.armor);
+                    player.hp -= dmg;
+                    if (drops) drops->addTaken(dmg);
+                }
+            }
+        }
+
+        s.rounds += static_cast<std::uint64_t>(round);
+        if (!player.alive()) {
+            ++s.losses;
+        } else if (first < enemies.size()) {
+            ++s.timeouts;
+        } else {
+            ++s.wins;
+            ++s.roundsToWin[static_cast<std::size_t>(round)];
+            ++s.hpOnWin[static_cast<std::size_t>(std::min(player.hp, cfg.player.maxHP))];
+        }
+        if (swapped) player.weapon = cfg.player.weapon;
+    }
+
+    s.encounters = encounters;
+    return s;
+}
+
+static unsigned workersFor(std::uint64_t total, unsigned threads) {
+    const std::uint64_t shards = (total + kSimShardSize - 1) / kSimShardSize;
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    if (threads > shards) threads = static_cast<unsigned>(std::max<std::uint64_t>(1, shards));
+    return threads;
+}
+
+// Calls shard(t, rng, count) for every kSimShardSize slice of `total`, with
+// rng = core::RNG::forStream(seed, k) for slice k and t the worker running
+// it. Workers claim slices from a shared counter; each writes only its own
+// partial results, so nothing is shared for writing until the join.
+template<typename Fn>
+static void forEachShard(std::uint64_t total, std::uint64_t seed, unsigned workers, const Fn& shard) {
+    const std::uint64_t shards = (total + kSimShardSize - 1) / kSimShardSize;
+    std::atomic<std::uint64_t> next{0};
+    auto worker = [&](unsigned t) {
+        for (std::uint64_t k = next++; k < shards; k = next++) {
+            const std::uint64_t begin = k * kSimShardSize;
+            core::RNG rng = core::RNG::forStream(seed, k);
+            shard(t, rng, std::min(kSimShardSize, total - begin));
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (unsigned t = 1; t < workers; ++t) pool.emplace_back(worker, t);
+    worker(0);
+    for (auto& th : pool) th.join();
+}
+
+SimStats simulateParallel(const SimConfig& cfg, const LootTables& loot, std::uint64_t seed,
+                          std::uint64_t encounters, unsigned threads, DropStats* drops) {
+    const unsigned workers = workersFor(encounters, threads);
+    std::vector<SimStats> partial(workers);
+    std::vector<DropStats> partialDrops(drops ? workers : 0, DropStats(drops ? drops->maxCombos() : 1));
+    forEachShard(encounters, seed, workers, [&](unsigned t, core::RNG& rng, std::uint64_t count) {
+        partial[t].merge(simulate(cfg, loot, rng, count, drops ? &partialDrops[t] : nullptr));
+    });
+
+    SimStats s;
+    for (const auto& p : partial) s.merge(p);
+    for (const auto& p : partialDrops) drops->merge(p);
+    return s;
+}
+
+void studyDrops(const LootTables& loot, int level, std::uint64_t seed, std::uint64_t drops,
+                DropStats& out, unsigned threads) {
+    const unsigned workers = workersFor(drops, threads);
+    std::vector<DropStats> partial(workers, DropStats(out.maxCombos()));
+    forEachShard(drops, seed, workers, [&](unsigned t, core::RNG& rng, std::uint64_t count) {
+        Item drop;
+        for (std::uint64_t n = 0; n < count; ++n) {
+            if (loot.rollIsGear(rng)) loot.rollGearInto(rng, level, drop);
+            else                      loot.rollWeaponInto(rng, level, drop);
+            partial[t].addKills();
+            partial[t].addDrop(drop);
+        }
+    });
+    for (const auto& p : partial) out.merge(p);
+}
+
+} // namespace game
@@ -0,0 +1,239 @@
+#include "game/tuner.hpp"
+#include "game/default_loot.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iterator>
+#include <set>
+#include <thread>
+
+namespace game {
+
+// Encounters per job. Budgets are whole numbers of these, and job k of every
+// configuration draws from stream k.
+static constexpr std::uint64_t kTuneShardSize = 1024;
+
+double TuneParam::value(int step) const {
+    if (steps <= 1) return lo;
+    return lo + (hi - lo) * double(step) / double(steps - 1);
+}
+
+double TuneTarget::loss(const SimStats& s) const {
+    double l = std::abs(s.winRate() - winRate);
+    if (roundsToWin > 0.0) l += roundsWeight * std::abs(s.meanRoundsToWin() - roundsToWin) / roundsToWin;
+    return l;
+}
+
+// ---------------------------------------------------------------------------
+// Loot configurations
+
+static bool rarityNamed(const std::string& name, std::size_t& out) {
+    for (std::size_t r = 0; r < std::size(default_loot::kRarityEntries); ++r) {
+        if (rarityName(default_loot::kRarityEntries[r].item) == name) { out = r; return true; }
+    }
+    return false;
+}
+
+template<typename Defs>
+static bool anyNamed(const Defs& defs, const std::string& name) {
+    return std::any_of(std::begin(defs), std::end(defs), [&](const auto& d) { return d.name == name; });
+}
+
+static bool baseNamed(const std::string& name) {
+    return std::any_of(std::begin(default_loot::kWeaponBaseEntries), std::end(default_loot::kWeaponBaseEntries),
+                       [&](const auto& e) { return e.item.name == name; });
+}
+
+TunedLoot::TunedLoot() : base_(makeEditableDefaultLoot()) {}
+
+bool TunedLoot::valid(const std::vector<TuneParam>& params) const {
+    for (const TuneParam& p : params) {
+        if (p.steps < 1) return false;
+        std::size_t r;
+        switch (p.knob) {
+            case TuneKnob::RarityWeight:
+                if (!rarityNamed(p.what, r) || p.lo <= 0.0 || p.hi <= 0.0) return false;
+                break;
+            case TuneKnob::WeaponDamage:
+                if (!p.what.empty() && !baseNamed(p.what)) return false;
+                break;
+            case TuneKnob::AffixScale:
+                if (!p.what.empty() && !anyNamed(default_loot::kPrefixes, p.what) &&
+                    !anyNamed(default_loot::kSuffixes, p.what)) return false;
+                break;
+        }
+    }
+    return true;
+}
+
+// The built pool's tiers, in kPrefixes/kSuffixes order, with tier i scaled
+// by scale[i]. The scale is applied as affixes roll, so the tiers keep the
+// default affix ids and nothing new is registered however many
+// configurations are made.
+static AffixPool scaledPool(const AffixPool& base, const std::vector<double>& scale) {
+    AffixPool pool;
+    const auto& tiers = base.tiers();
+    for (std::size_t i = 0; i < tiers.size(); ++i) {
+        const AffixTier& t = tiers[i];
+        pool.add(t.affix, t.weight, t.minLevel, t.maxLevel, scale[i]);
+    }
+    pool.build();
+    return pool;
+}
+
+LootTables TunedLoot::make(const std::vector<TuneParam>& params, const std::vector<double>& values) const {
+    using namespace default_loot;
+    std::vector<double> rarityW, damage(std::size(kWeaponBaseEntries), 1.0);
+    std::vector<double> prefixK(std::size(kPrefixes), 1.0), suffixK(std::size(kSuffixes), 1.0);
+    for (const auto& e : kRarityEntries) rarityW.push_back(e.weight);
+    bool rarity = false, bases = false, affixes = false;
+
+    // Scales on the same target multiply; a rarity weight is just replaced.
+    for (std::size_t i = 0; i < params.size() && i < values.size(); ++i) {
+        const TuneParam& p = params[i];
+        const double v = values[i];
+        std::size_t r;
+        switch (p.knob) {
+            case TuneKnob::RarityWeight:
+                if (rarityNamed(p.what, r)) { rarityW[r] = v; rarity = true; }
+                break;
+            case TuneKnob::WeaponDamage:
+                for (std::size_t b = 0; b < damage.size(); ++b) {
+                    if (p.what.empty() || kWeaponBaseEntries[b].item.name == p.what) { damage[b] *= v; bases = true; }
+                }
+                break;
+            case TuneKnob::AffixScale:
+                for (std::size_t t = 0; t < prefixK.size(); ++t) {
+                    if (p.what.empty() || kPrefixes[t].name == p.what) { prefixK[t] *= v; affixes = true; }
+                }
+                for (std::size_t t = 0; t < suffixK.size(); ++t) {
+                    if (p.what.empty() || kSuffixes[t].name == p.what) { suffixK[t] *= v; affixes = true; }
+                }
+                break;
+        }
+    }
+
+    // Untouched tables come across already compiled.
+    LootTables lt = base_;
+    if (rarity) {
+        lt.rarity = {};
+        for (std::size_t r = 0; r < rarityW.size(); ++r) lt.rarity.add(kRarityEntries[r].item, rarityW[r]);
+        lt.rarity.build();
+    }
+    if (bases) {
+        lt.bases = {};
+        for (std::size_t b = 0; b < damage.size(); ++b) {
+            const auto& e = kWeaponBaseEntries[b];
+            const int mn = std::max(1, static_cast<int>(std::lround(e.item.baseMin * damage[b])));
+            const int mx = std::max(mn, static_cast<int>(std::lround(e.item.baseMax * damage[b])));
+            lt.bases.add(WeaponBase{std::string(e.item.name), mn, mx}, e.weight);
+        }
+        lt.bases.build();
+    }
+    if (affixes) {
+        lt.prefixes = scaledPool(base_.prefixes, prefixK);
+        lt.suffixes = scaledPool(base_.suffixes, suffixK);
+    }
+    return lt;
+}
+
+// ---------------------------------------------------------------------------
+// Search
+
+// Grid points as per-parameter step indices: the whole grid when it fits in
+// maxConfigs, otherwise distinct random points.
+static std::vector<std::vector<int>> gridPoints(const std::vector<TuneParam>& params, std::size_t maxConfigs,
+                                                std::uint64_t seed) {
+    std::size_t total = 1;
+    for (const TuneParam& p : params) {
+        total = total > maxConfigs ? total : total * static_cast<std::size_t>(p.steps);
+    }
+
+    std::vector<std::vector<int>> points;
+    if (total <= maxConfigs) {
+        std::vector<int> at(params.size(), 0);
+        for (std::size_t n = 0; n < total; ++n) {
+            points.push_back(at);
+            for (std::size_t i = 0; i < at.size() && ++at[i] == params[i].steps; ++i) at[i] = 0;
+        }
+        return points;
+    }
+
+    core::RNG rng(seed);
+    std::set<std::vector<int>> seen;
+    for (std::size_t tries = 0; points.size() < maxConfigs && tries < 20 * maxConfigs; ++tries) {
+        std::vector<int> at(params.size());
+        for (std::size_t i = 0; i < at.size(); ++i) at[i] = static_cast<int>(rng.below(params[i].steps));
+        if (seen.insert(at).second) points.push_back(std::move(at));
+    }
+    return points;
+}
+
+TuneResult tune(const SimConfig& cfg, const std::vector<TuneParam>& params, const TuneTarget& target,
+                const TuneOptions& opt) {
+    TuneResult res;
+    const TunedLoot tuned;
+    if (!tuned.valid(params)) return res;
+
+    // Every configuration's tables are made up front, on this thread.
+    std::vector<TuneConfig> configs;
+    std::vector<LootTables> loot;
+    for (const auto& at : gridPoints(params, std::max<std::size_t>(1, opt.maxConfigs), opt.seed)) {
+        TuneConfig c;
+        for (std::size_t i = 0; i < params.size(); ++i) c.values.push_back(params[i].value(at[i]));
+        loot.push_back(tuned.make(params, c.values));
+        configs.push_back(std::move(c));
+    }
+
+    auto shardsFor = [](std::uint64_t n) { return std::max<std::uint64_t>(1, (n + kTuneShardSize - 1) / kTuneShardSize); };
+    const std::uint64_t eta       = std::max(2u, opt.eta);
+    const std::uint64_t maxShards = std::max(shardsFor(opt.minEncounters), shardsFor(opt.maxEncounters));
+    std::uint64_t done = 0, budget = shardsFor(opt.minEncounters);
+    const unsigned hw = opt.threads ? opt.threads : std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<std::size_t> alive(configs.size());
+    for (std::size_t i = 0; i < alive.size(); ++i) alive[i] = i;
+
+    while (!alive.empty()) {
+        // One job per (surviving configuration, new shard); results are
+        // merged in job order after the join.
+        const std::uint64_t per  = budget - done;
+        const std::uint64_t jobs = alive.size() * per;
+        std::vector<SimStats> partial(jobs);
+        std::atomic<std::uint64_t> next{0};
+        auto worker = [&] {
+            for (std::uint64_t j = next++; j < jobs; j = next++) {
+                core::RNG rng = core::RNG::forStream(opt.seed, done + j % per);
+                partial[j] = simulate(cfg, loot[alive[j / per]], rng, kTuneShardSize);
+            }
+        };
+        const unsigned workers = static_cast<unsigned>(std::min<std::uint64_t>(hw, jobs));
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < workers; ++t) pool.emplace_back(worker);
+        worker();
+        for (auto& th : pool) th.join();
+
+        for (std::uint64_t j = 0; j < jobs; ++j) configs[alive[j / per]].stats.merge(partial[j]);
+        for (std::size_t c : alive) {
+            configs[c].loss = target.loss(configs[c].stats);
+            ++configs[c].rungs;
+        }
+        res.encounters += jobs * kTuneShardSize;
+        ++res.rungs;
+
+        std::stable_sort(alive.begin(), alive.end(),
+                         [&](std::size_t a, std::size_t b) { return configs[a].loss < configs[b].loss; });
+        if (alive.size() == 1 || budget >= maxShards) break;
+        alive.resize((alive.size() + eta - 1) / eta);
+        done   = budget;
+        budget = std::min(budget * eta, maxShards);
+    }
+
+    res.configs = std::move(configs);
+    std::stable_sort(res.configs.begin(), res.configs.end(), [](const TuneConfig& a, const TuneConfig& b) {
+        return a.rungs != b.rungs ? a.rungs > b.rungs : a.loss < b.loss;
+    });
+    return res;
+}
+
+} // namespace game
@@ -0,0 +1,87 @@
+#include "game/weapon_columns.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace game {
+
+void WeaponColumns::clear() {
+    minDmg.clear(); maxDmg.clear(); pct.clear(); crit.clear();
+    critMult.clear(); as.clear(); twoHanded.clear();
+}
+
+void WeaponColumns::push_back(const Item& w) {
+    minDmg.push_back(w.minDmg());
+    maxDmg.push_back(w.maxDmg());
+    pct.push_back(w.pctDamage());
+    crit.push_back(w.critChance());
+    critMult.push_back(w.critMult());
+    as.push_back(w.attackSpeed());
+    twoHanded.push_back(w.twoHanded ? 1 : 0);
+}
+
+void WeaponColumns::swapRemove(std::size_t i) {
+    auto drop = [i](auto& col) { col[i] = col.back(); col.pop_back(); };
+    drop(minDmg); drop(maxDmg); drop(pct); drop(crit);
+    drop(critMult); drop(as); drop(twoHanded);
+}
+
+void WeaponColumns::assign(const Item* weapons, std::size_t n) {
+    clear();
+    for (std::size_t i = 0; i < n; ++i) push_back(weapons[i]);
+}
+
+void WeaponColumns::dpr(const GearBonuses& b, double* out) const {
+    const std::size_t n = size();
+    const int*    __restrict mn = minDmg.data();
+    const int*    __restrict mx = maxDmg.data();
+    const double* __restrict pc = pct.data();
+    const double* __restrict cc = crit.data();
+    const double* __restrict cm = critMult.data();
+    const double* __restrict sp = as.data();
+    double*       __restrict o  = out;
+
+    // Same operations and order as expectedDamagePerSwing() * expectedAPS();
+    // std::clamp/std::max are spelled as min/max so the loop stays branch-free.
+    for (std::size_t i = 0; i < n; ++i) {
+        const double avg    = (mn[i] + mx[i]) / 2.0;
+        const double scaled = avg * (1.0 + pc[i] + b.pctDamage);
+        const double critC  = std::min(std::max(cc[i] + b.critChance, 0.0), 0.95);
+        const double swing  = scaled * (1.0 + critC * (cm[i] - 1.0));
+        const double aps    = std::max(0.2, 1.0 + sp[i] + b.attackSpeed);
+        o[i] = swing * aps;
+    }
+}
+
+std::size_t WeaponColumns::best(const GearBonuses& b, bool oneHandedOnly) const {
+    const std::size_t n = size();
+    if (n == 0) return npos;
+    std::vector<double> d(n);
+    dpr(b, d.data());
+
+    double bestV = -std::numeric_limits<double>::infinity();
+    std::size_t bestIdx = npos;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (oneHandedOnly && twoHanded[i]) continue;
+        if (d[i] > bestV) { bestV = d[i]; bestIdx = i; }
+    }
+    return bestIdx;
+}
+
+std::vector<std::size_t> WeaponColumns::topK(const GearBonuses& b, std::size_t k, bool oneHandedOnly) const {
+    const std::size_t n = size();
+    std::vector<double> d(n);
+    dpr(b, d.data());
+
+    std::vector<std::size_t> idx;
+    idx.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (!(oneHandedOnly && twoHanded[i])) idx.push_back(i);
+    }
+    k = std::min(k, idx.size());
+    auto byDPR = [&](std::size_t x, std::size_t y){ return d[x] > d[y] || (d[x] == d[y] && x < y); };
+    std::partial_sort(idx.begin(), idx.begin() + static_cast<std::ptrdiff_t>(k), idx.end(), byDPR);
+    idx.resize(k);
+    return idx;
+}
+
+} // namespace game